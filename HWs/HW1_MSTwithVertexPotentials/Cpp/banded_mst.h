@@ -0,0 +1,456 @@
+#ifndef CPP_BANDED_MST_H
+#define CPP_BANDED_MST_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "vertex_costs.h"
+
+/**
+ * Exact MST cost of the grid computed in horizontal bands of rows, for grids whose per-vertex state does not fit
+ * in memory. The costs of the vertices live in a temporary file.
+ *
+ * Costs: every band, widened by one row on both sides, is relaxed in memory by a Dijkstra over {distance, potential}
+ * seeded with the costs from the file and, over the extra edges, with the costs of their other endpoints, which are
+ * kept in memory. Bands are swept down and up until no band is left whose rows or seeds changed since it was relaxed.
+ *
+ * MST: the bands are added top to bottom to a contracted forest of the rows above. An edge missing from the MST of
+ * the rows so far is the heaviest on a cycle and misses the final MST as well. Then only the terminals are kept:
+ * the last row and the endpoints of extra edges into the rows below. A leaf that is not a terminal is connected
+ * by its only edge, a non-terminal with two edges by the cheaper one while the dearer one joins its neighbours.
+ * The forest left has fewer than twice as many vertices as there are terminals.
+ *
+ * Memory is about BYTES_PER_BAND_VERTEX per vertex of a band plus the extra edges, potentials are read in place.
+ */
+class BandedMST {
+public:
+    static constexpr uint64_t BYTES_PER_BAND_VERTEX = 80;
+
+    uint32_t bandRows;
+    uint32_t sweeps = 0;
+
+    /**
+     * @param potentials - potentialCount x {vertex, potential}
+     * @param extraEdges - extraEdgeCount x {from, to}
+     * @param memoryCap - bytes for the state of a band, at least one row is kept
+     */
+    BandedMST(uint32_t rows, uint32_t columns, const uint32_t *potentials, uint32_t potentialCount,
+              const uint32_t *extraEdges, uint32_t extraEdgeCount, uint64_t memoryCap)
+            : rows(rows), columns(columns), potentials(potentials), potentialCount(potentialCount) {
+        uint64_t capRows = memoryCap / (BYTES_PER_BAND_VERTEX * std::max<uint32_t>(columns, 1));
+        bandRows = (uint32_t) std::max<uint64_t>(1, std::min<uint64_t>(capRows, rows));
+        for (size_t i = 0; i < extraEdgeCount; ++i) {
+            uint32_t from = extraEdges[2 * i], to = extraEdges[2 * i + 1];
+            if (from != to) {
+                halfEdges.emplace_back(from, to);
+                halfEdges.emplace_back(to, from);
+                extraByLast.emplace_back(std::max(from, to), std::min(from, to));
+            }
+        }
+        std::sort(halfEdges.begin(), halfEdges.end());
+        std::sort(extraByLast.begin(), extraByLast.end());
+        for (const std::pair<uint32_t, uint32_t> &halfEdge : halfEdges) {
+            if (endpoints.empty() || endpoints.back() != halfEdge.first) {
+                endpoints.push_back(halfEdge.first);
+            }
+        }
+        endpointCosts.assign(endpoints.size(), UNREACHED);
+    }
+
+    BandedMST(const BandedMST &) = delete;
+
+    BandedMST &operator=(const BandedMST &) = delete;
+
+    ~BandedMST() {
+        if (costFile != nullptr) {
+            std::fclose(costFile);
+        }
+    }
+
+    /**
+     * @return false when the temporary file could not be created, read or written
+     */
+    bool run(uint64_t &MSTcost) {
+        costFile = std::tmpfile();
+        if (costFile == nullptr || !writeSources()) {
+            return false;
+        }
+        dirty.assign(bandCount(), true);
+        for (bool down = true; std::find(dirty.begin(), dirty.end(), true) != dirty.end() && !failed; down = !down) {
+            for (uint32_t i = 0; i < bandCount() && !failed; ++i) {
+                uint32_t band = down ? i : bandCount() - 1 - i;
+                if (dirty[band]) {
+                    relaxBand(band);
+                }
+            }
+            sweeps++;
+        }
+        MSTcost = 0;
+        std::vector<WeightedEdge> forest;
+        std::vector<VertexCosts> previousRow;
+        for (uint32_t first = 0; first < rows && !failed; first += bandRows) {
+            MSTcost += addBand(first, std::min(rows, first + bandRows), forest, previousRow);
+        }
+        return !failed;
+    }
+
+private:
+    struct WeightedEdge {
+        uint32_t from;
+        uint32_t to;
+        uint32_t cost;
+    };
+
+    // distance, potential, vertex of the band
+    using QueueEntry = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+    const VertexCosts UNREACHED{UINT32_MAX, UINT32_MAX};
+    const uint32_t rows;
+    const uint32_t columns;
+    const uint32_t *potentials;
+    const uint32_t potentialCount;
+    std::vector<std::pair<uint32_t, uint32_t>> halfEdges; // {vertex, other endpoint} of every extra edge, sorted
+    std::vector<std::pair<uint32_t, uint32_t>> extraByLast; // {greater, smaller endpoint}, sorted
+    std::vector<uint32_t> endpoints;
+    std::vector<VertexCosts> endpointCosts;
+    std::vector<bool> dirty; // bands whose rows or seeds changed since they were relaxed
+    FILE *costFile = nullptr;
+    bool failed = false;
+
+    uint32_t bandCount() const {
+        return (rows + bandRows - 1) / bandRows;
+    }
+
+    uint64_t vertexOf(uint32_t row) const {
+        return (uint64_t) row * columns;
+    }
+
+    void readRows(uint32_t first, uint32_t last, std::vector<VertexCosts> &costs) {
+        costs.resize(vertexOf(last) - vertexOf(first));
+        size_t bytes = costs.size() * sizeof(VertexCosts);
+        failed |= pread(fileno(costFile), costs.data(), bytes, vertexOf(first) * sizeof(VertexCosts)) != (ssize_t) bytes;
+    }
+
+    void writeRows(uint32_t first, const std::vector<VertexCosts> &costs) {
+        size_t bytes = costs.size() * sizeof(VertexCosts);
+        failed |= pwrite(fileno(costFile), costs.data(), bytes, vertexOf(first) * sizeof(VertexCosts)) != (ssize_t) bytes;
+    }
+
+    VertexCosts &endpointCost(uint32_t vertex) {
+        return endpointCosts[std::lower_bound(endpoints.begin(), endpoints.end(), vertex) - endpoints.begin()];
+    }
+
+    /**
+     * Every band starts at infinity except the vertices with potential, a vertex given twice keeps the later potential.
+     */
+    bool writeSources() {
+        std::vector<uint32_t> order(potentialCount);
+        for (uint32_t i = 0; i < potentialCount; ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return std::make_pair(potentials[2 * a], a) < std::make_pair(potentials[2 * b], b);
+        });
+        std::vector<VertexCosts> band;
+        size_t next = 0;
+        for (uint32_t first = 0; first < rows; first += bandRows) {
+            uint32_t last = std::min(rows, first + bandRows);
+            band.assign(vertexOf(last) - vertexOf(first), UNREACHED);
+            for (; next < order.size() && potentials[2 * order[next]] < vertexOf(last); ++next) {
+                band[potentials[2 * order[next]] - vertexOf(first)] = {0, potentials[2 * order[next] + 1]};
+            }
+            writeRows(first, band);
+        }
+        return !failed;
+    }
+
+    uint32_t bandOf(uint64_t vertex) const {
+        return (uint32_t) (vertex / columns / bandRows);
+    }
+
+    /**
+     * Relaxes the rows of the band with one row around them to a fixpoint within them,
+     * the neighbouring bands and the bands across the extra edges of the improved vertices get dirty.
+     */
+    void relaxBand(uint32_t band) {
+        uint32_t first = band * bandRows, last = std::min(rows, first + bandRows);
+        uint32_t top = first > 0 ? first - 1 : 0, bottom = std::min(rows, last + 1);
+        uint64_t begin = vertexOf(top), end = vertexOf(bottom);
+        std::vector<VertexCosts> costs;
+        readRows(top, bottom, costs);
+        auto extraFirst = std::lower_bound(halfEdges.begin(), halfEdges.end(), std::make_pair((uint32_t) begin, 0u));
+        auto extraLast = std::lower_bound(extraFirst, halfEdges.end(), std::make_pair((uint32_t) end, 0u));
+
+        bool changed = false;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        auto improve = [&](uint32_t local, const VertexCosts &from) {
+            if (from.edge_distance_to_potential == UINT32_MAX) {
+                return;
+            }
+            VertexCosts candidate{from.edge_distance_to_potential + 1, from.potential};
+            if (lessCosts(candidate, costs[local])) {
+                costs[local] = candidate;
+                queue.emplace(candidate.edge_distance_to_potential, candidate.potential, local);
+                changed = true;
+            }
+        };
+        for (uint32_t local = 0; local < costs.size(); ++local) {
+            if (costs[local].edge_distance_to_potential != UINT32_MAX) {
+                queue.emplace(costs[local].edge_distance_to_potential, costs[local].potential, local);
+            }
+        }
+        for (auto halfEdge = extraFirst; halfEdge != extraLast; ++halfEdge) {
+            if (halfEdge->second < begin || halfEdge->second >= end) {
+                improve((uint32_t) (halfEdge->first - begin), endpointCost(halfEdge->second));
+            }
+        }
+        while (!queue.empty()) {
+            uint32_t distance, potential, local;
+            std::tie(distance, potential, local) = queue.top();
+            queue.pop();
+            VertexCosts current = costs[local];
+            if (current.edge_distance_to_potential != distance || current.potential != potential) {
+                continue;
+            }
+            uint32_t column = local % columns;
+            if (column > 0) {
+                improve(local - 1, current);
+            }
+            if (column + 1 < columns) {
+                improve(local + 1, current);
+            }
+            if (local >= columns) {
+                improve(local - columns, current);
+            }
+            if (local + columns < costs.size()) {
+                improve(local + columns, current);
+            }
+            auto halfEdge = std::lower_bound(extraFirst, extraLast, std::make_pair((uint32_t) (begin + local), 0u));
+            for (; halfEdge != extraLast && halfEdge->first == begin + local; ++halfEdge) {
+                if (halfEdge->second >= begin && halfEdge->second < end) {
+                    improve((uint32_t) (halfEdge->second - begin), current);
+                }
+            }
+        }
+
+        dirty[band] = false;
+        if (changed) {
+            writeRows(top, costs);
+            if (band > 0) {
+                dirty[band - 1] = true;
+            }
+            if (band + 1 < bandCount()) {
+                dirty[band + 1] = true;
+            }
+        }
+        auto endpoint = std::lower_bound(endpoints.begin(), endpoints.end(), (uint32_t) begin);
+        auto halfEdge = extraFirst;
+        for (; endpoint != endpoints.end() && *endpoint < end; ++endpoint) {
+            VertexCosts &known = endpointCosts[endpoint - endpoints.begin()];
+            bool improved = lessCosts(costs[*endpoint - begin], known);
+            if (improved) {
+                known = costs[*endpoint - begin];
+            }
+            for (; halfEdge != extraLast && halfEdge->first == *endpoint; ++halfEdge) {
+                if (improved && (halfEdge->second < begin || halfEdge->second >= end)) {
+                    dirty[bandOf(halfEdge->second)] = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * Adds the rows [first, last) to the contracted forest of the rows above.
+     * @param previousRow - costs of the row first - 1, replaced by the costs of the row last - 1
+     * @return cost of the edges that were contracted
+     */
+    uint64_t addBand(uint32_t first, uint32_t last, std::vector<WeightedEdge> &forest, std::vector<VertexCosts> &previousRow) {
+        uint64_t begin = vertexOf(first), end = vertexOf(last);
+        uint32_t bandSize = (uint32_t) (end - begin);
+        std::vector<VertexCosts> costs;
+        readRows(first, last, costs);
+        auto extraFirst = std::lower_bound(extraByLast.begin(), extraByLast.end(), std::make_pair((uint32_t) begin, 0u));
+        auto extraLast = std::lower_bound(extraFirst, extraByLast.end(), std::make_pair((uint32_t) end, 0u));
+
+        // vertices above the band are numbered after the band
+        std::vector<uint32_t> above;
+        for (const WeightedEdge &edge : forest) {
+            above.push_back(edge.from);
+            above.push_back(edge.to);
+        }
+        for (uint32_t column = 0; first > 0 && column < columns; ++column) {
+            above.push_back((uint32_t) (begin - columns + column));
+        }
+        for (auto extra = extraFirst; extra != extraLast; ++extra) {
+            if (extra->second < begin) {
+                above.push_back(extra->second);
+            }
+        }
+        std::sort(above.begin(), above.end());
+        above.erase(std::unique(above.begin(), above.end()), above.end());
+        auto local = [&](uint64_t vertex) {
+            return vertex >= begin ? (uint32_t) (vertex - begin)
+                                   : bandSize + (uint32_t) (std::lower_bound(above.begin(), above.end(), vertex) - above.begin());
+        };
+        auto costsOf = [&](uint64_t vertex) -> const VertexCosts & {
+            if (vertex >= begin) {
+                return costs[vertex - begin];
+            }
+            return vertex >= begin - columns ? previousRow[vertex - (begin - columns)] : endpointCost((uint32_t) vertex);
+        };
+        auto edgeCost = [&](uint64_t from, uint64_t to) {
+            return getEdgeCost(costsOf(from), costsOf(to));
+        };
+
+        std::vector<WeightedEdge> candidates;
+        candidates.reserve(forest.size() + 2 * (size_t) bandSize + (extraLast - extraFirst));
+        for (const WeightedEdge &edge : forest) {
+            candidates.push_back({local(edge.from), local(edge.to), edge.cost});
+        }
+        for (uint64_t vertex = begin; vertex < end; ++vertex) {
+            if ((vertex + 1) % columns != 0) {
+                candidates.push_back({local(vertex), local(vertex + 1), edgeCost(vertex, vertex + 1)});
+            }
+            if (vertex >= columns) {
+                candidates.push_back({local(vertex - columns), local(vertex), edgeCost(vertex - columns, vertex)});
+            }
+        }
+        for (auto extra = extraFirst; extra != extraLast; ++extra) {
+            candidates.push_back({local(extra->second), local(extra->first), edgeCost(extra->second, extra->first)});
+        }
+
+        uint32_t vertexCount = bandSize + (uint32_t) above.size();
+        std::vector<WeightedEdge> tree = kruskal(candidates, vertexCount);
+        std::vector<WeightedEdge>().swap(candidates);
+
+        std::vector<bool> terminal(vertexCount, false);
+        if (last < rows) {
+            std::fill(terminal.begin() + (bandSize - columns), terminal.begin() + bandSize, true);
+        }
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            uint32_t global = vertex < bandSize ? (uint32_t) (begin + vertex) : above[vertex - bandSize];
+            auto halfEdge = std::lower_bound(halfEdges.begin(), halfEdges.end(), std::make_pair(global, 0u));
+            for (; halfEdge != halfEdges.end() && halfEdge->first == global && !terminal[vertex]; ++halfEdge) {
+                terminal[vertex] = halfEdge->second >= end;
+            }
+        }
+        uint64_t contracted = contract(tree, terminal);
+
+        forest.clear();
+        for (const WeightedEdge &edge : tree) {
+            auto global = [&](uint32_t vertex) {
+                return vertex < bandSize ? (uint32_t) (begin + vertex) : above[vertex - bandSize];
+            };
+            forest.push_back({global(edge.from), global(edge.to), edge.cost});
+        }
+        previousRow.assign(costs.end() - columns, costs.end());
+        return contracted;
+    }
+
+    static std::vector<WeightedEdge> kruskal(std::vector<WeightedEdge> &edges, uint32_t vertexCount) {
+        std::sort(edges.begin(), edges.end(), [](const WeightedEdge &a, const WeightedEdge &b) { return a.cost < b.cost; });
+        std::vector<uint32_t> parent(vertexCount);
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            parent[vertex] = vertex;
+        }
+        auto find = [&parent](uint32_t vertex) {
+            while (parent[vertex] != vertex) {
+                parent[vertex] = parent[parent[vertex]];
+                vertex = parent[vertex];
+            }
+            return vertex;
+        };
+        std::vector<WeightedEdge> tree;
+        tree.reserve(vertexCount);
+        for (const WeightedEdge &edge : edges) {
+            uint32_t a = find(edge.from), b = find(edge.to);
+            if (a != b) {
+                parent[std::max(a, b)] = std::min(a, b);
+                tree.push_back(edge);
+            }
+        }
+        return tree;
+    }
+
+    /**
+     * Removes the non-terminal leaves and joins the neighbours of the non-terminals with two edges,
+     * the edges left are the contracted forest.
+     * @return cost of the edges that were contracted
+     */
+    static uint64_t contract(std::vector<WeightedEdge> &tree, const std::vector<bool> &terminal) {
+        size_t vertexCount = terminal.size();
+        std::vector<uint32_t> offsets(vertexCount + 1, 0), degree(vertexCount, 0);
+        for (const WeightedEdge &edge : tree) {
+            offsets[edge.from + 1]++;
+            offsets[edge.to + 1]++;
+        }
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+            offsets[vertex + 1] += offsets[vertex];
+        }
+        // degrees never grow, so every vertex keeps its slots for the ids of its edges
+        std::vector<uint32_t> slots(offsets.back());
+        for (uint32_t id = 0; id < tree.size(); ++id) {
+            slots[offsets[tree[id].from] + degree[tree[id].from]++] = id;
+            slots[offsets[tree[id].to] + degree[tree[id].to]++] = id;
+        }
+        auto other = [&tree](uint32_t id, uint32_t vertex) {
+            return tree[id].from == vertex ? tree[id].to : tree[id].from;
+        };
+        auto replace = [&](uint32_t vertex, uint32_t id, uint32_t by) {
+            uint32_t *slot = std::find(&slots[offsets[vertex]], &slots[offsets[vertex]] + degree[vertex], id);
+            if (by == UINT32_MAX) {
+                *slot = slots[offsets[vertex] + --degree[vertex]];
+            } else {
+                *slot = by;
+            }
+        };
+
+        std::vector<bool> alive(tree.size(), true);
+        std::vector<uint32_t> stack;
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            if (!terminal[vertex] && degree[vertex] <= 2) {
+                stack.push_back(vertex);
+            }
+        }
+        uint64_t contracted = 0;
+        while (!stack.empty()) {
+            uint32_t vertex = stack.back();
+            stack.pop_back();
+            if (degree[vertex] == 1) {
+                uint32_t id = slots[offsets[vertex]], neighbor = other(id, vertex);
+                contracted += tree[id].cost;
+                alive[id] = false;
+                degree[vertex] = 0;
+                replace(neighbor, id, UINT32_MAX);
+                if (!terminal[neighbor] && degree[neighbor] <= 2) {
+                    stack.push_back(neighbor);
+                }
+            } else if (degree[vertex] == 2) {
+                uint32_t kept = slots[offsets[vertex]], joined = slots[offsets[vertex] + 1];
+                uint32_t a = other(kept, vertex), b = other(joined, vertex);
+                contracted += std::min(tree[kept].cost, tree[joined].cost);
+                tree[kept] = {a, b, std::max(tree[kept].cost, tree[joined].cost)};
+                alive[joined] = false;
+                degree[vertex] = 0;
+                replace(b, joined, kept);
+            }
+        }
+        size_t left = 0;
+        for (uint32_t id = 0; id < tree.size(); ++id) {
+            if (alive[id]) {
+                tree[left++] = tree[id];
+            }
+        }
+        tree.resize(left);
+        return contracted;
+    }
+};
+
+#endif //CPP_BANDED_MST_H
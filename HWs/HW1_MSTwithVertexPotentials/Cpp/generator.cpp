@@ -0,0 +1,47 @@
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "../../../common/generator.h"
+
+/**
+ * Grid with potentials and extra edges, scale 1 is the size of pub12 (620 x 513 grid, 33 potentials,
+ * 991 extra edges), rows and columns grow with the square root of the scale.
+ * Potential vertices and potentials are distinct, extra edges never connect grid neighbours
+ * and every vertex has at most one of them, as the assignment requires.
+ * usage: generator [scale] [seed]
+ */
+int main(int argc, char *argv[]) {
+    GeneratorArguments arguments(argc, argv);
+    Random random(arguments.seed);
+
+    uint64_t rows = std::max<uint64_t>(2, (uint64_t) std::llround(620 * std::sqrt(arguments.scale)));
+    uint64_t columns = std::max<uint64_t>(2, (uint64_t) std::llround(513 * std::sqrt(arguments.scale)));
+    uint64_t vertices = rows * columns;
+    uint64_t potential_count = std::min<uint64_t>(1 + (uint64_t) std::sqrt((double) vertices),
+                                                  (uint64_t) std::ceil(33 * std::sqrt(arguments.scale)));
+    uint64_t extra_count = std::min<uint64_t>((uint64_t) std::llround(991 * arguments.scale), vertices / 4);
+    uint64_t max_potential = std::max<uint64_t>(10000, potential_count);
+
+    Output out;
+    out << rows << ' ' << columns << ' ' << potential_count << ' ' << extra_count << '\n';
+
+    RandomPermutation potential_vertex(vertices, random), potential_value(max_potential, random);
+    for (uint64_t i = 0; i < potential_count; ++i) {
+        uint64_t vertex = potential_vertex(i);
+        out << vertex / columns + 1 << ' ' << vertex % columns + 1 << ' ' << potential_value(i) + 1 << '\n';
+    }
+
+    // consecutive pairs of a permutation are distinct vertices, each one used at most once
+    RandomPermutation endpoint(vertices, random);
+    for (uint64_t pair = 0, written = 0; written < extra_count; ++pair) {
+        uint64_t from = endpoint(2 * pair), to = endpoint(2 * pair + 1);
+        uint64_t row_distance = std::max(from / columns, to / columns) - std::min(from / columns, to / columns);
+        uint64_t column_distance = std::max(from % columns, to % columns) - std::min(from % columns, to % columns);
+        if (row_distance + column_distance == 1) {
+            continue;
+        }
+        out << from / columns + 1 << ' ' << from % columns + 1 << ' ' << to / columns + 1 << ' ' << to % columns + 1 << '\n';
+        written++;
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "incremental_mst.h"
+
+/**
+ * Latency of potential updates in IncrementalMST against recomputing everything from scratch.
+ * Adds, changes and removes random vertices with potential of the input grid, after every few updates
+ * the grid is recomputed from scratch, by the BFS and Kruskal of the constructor, and both costs are compared.
+ * usage: incremental_benchmark [updates] [seed] < input
+ */
+
+using Clock = std::chrono::steady_clock;
+
+struct Grid {
+    uint32_t rows{}, cols{};
+    std::vector<uint32_t> potentials; // {vertex, potential} pairs
+    std::vector<uint32_t> extraEdges;
+};
+
+Grid read_grid(std::istream &input) {
+    Grid grid;
+    uint32_t potentialCount{}, extraEdgeCount{};
+    input >> grid.rows >> grid.cols >> potentialCount >> extraEdgeCount;
+    for (uint32_t i = 0; i < potentialCount; ++i) {
+        uint32_t row{}, col{}, potential{};
+        input >> row >> col >> potential;
+        grid.potentials.push_back((row - 1) * grid.cols + col - 1);
+        grid.potentials.push_back(potential);
+    }
+    for (uint32_t i = 0; i < 2 * extraEdgeCount; ++i) {
+        uint32_t row{}, col{};
+        input >> row >> col;
+        grid.extraEdges.push_back((row - 1) * grid.cols + col - 1);
+    }
+    return grid;
+}
+
+void set_potential(Grid &grid, uint32_t vertex, uint32_t potential, bool present) {
+    size_t kept = 0;
+    for (size_t i = 0; i < grid.potentials.size(); i += 2) {
+        if (grid.potentials[i] != vertex) {
+            grid.potentials[kept++] = grid.potentials[i];
+            grid.potentials[kept++] = grid.potentials[i + 1];
+        }
+    }
+    grid.potentials.resize(kept);
+    if (present) {
+        grid.potentials.push_back(vertex);
+        grid.potentials.push_back(potential);
+    }
+}
+
+double milliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t) (fraction * values.size()))];
+}
+
+uint64_t recompute(const Grid &grid, double &ms) {
+    auto start = Clock::now();
+    IncrementalMST full(grid.rows, grid.cols, grid.potentials.data(), (uint32_t) grid.potentials.size() / 2,
+                        grid.extraEdges.data(), (uint32_t) grid.extraEdges.size() / 2);
+    ms = milliseconds(start);
+    return full.cost();
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t updates = argc > 1 ? (uint32_t) std::strtoul(argv[1], nullptr, 10) : 200;
+    uint32_t seed = argc > 2 ? (uint32_t) std::strtoul(argv[2], nullptr, 10) : 42;
+    std::mt19937 generator(seed);
+    std::ios_base::sync_with_stdio(false);
+    Grid grid = read_grid(std::cin);
+    uint32_t vertices = grid.rows * grid.cols;
+
+    double fullMs;
+    recompute(grid, fullMs);
+    IncrementalMST incremental(grid.rows, grid.cols, grid.potentials.data(), (uint32_t) grid.potentials.size() / 2,
+                               grid.extraEdges.data(), (uint32_t) grid.extraEdges.size() / 2);
+
+    const char *names[3] = {"add", "change", "remove"};
+    std::vector<double> times[3], fullTimes{fullMs};
+    uint64_t changedVertices[3] = {0, 0, 0};
+    uint32_t checkEvery = std::max<uint32_t>(1, updates / 5);
+    std::uniform_int_distribution<uint32_t> anyVertex(0, vertices - 1), anyPotential(1, 10000), kind(0, 2);
+    for (uint32_t update = 1; update <= updates; ++update) {
+        size_t potentialCount = grid.potentials.size() / 2;
+        uint32_t type = potentialCount <= 1 ? 0 : kind(generator);
+        uint32_t vertex = type == 0 ? anyVertex(generator)
+                                    : grid.potentials[2 * std::uniform_int_distribution<size_t>(0, potentialCount - 1)(generator)];
+        uint32_t potential = anyPotential(generator);
+        auto start = Clock::now();
+        if (type == 2) {
+            incremental.removePotential(vertex);
+        } else {
+            incremental.setPotential(vertex, potential);
+        }
+        times[type].push_back(milliseconds(start));
+        set_potential(grid, vertex, potential, type != 2);
+        changedVertices[type] += incremental.changedVertices();
+
+        if (update % checkEvery == 0 || update == updates) {
+            double ms;
+            uint64_t expected = recompute(grid, ms);
+            fullTimes.push_back(ms);
+            if (expected != incremental.cost()) {
+                std::cerr << "update " << update << ": incremental cost " << incremental.cost()
+                          << ", recomputed " << expected << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "grid " << grid.rows << " x " << grid.cols << ", cost " << incremental.cost() << std::endl;
+    std::cout << std::left << std::setw(10) << "update" << std::right << std::setw(8) << "count"
+              << std::setw(12) << "median ms" << std::setw(12) << "p95 ms" << std::setw(12) << "max ms"
+              << std::setw(16) << "changed/update" << std::endl;
+    for (int type = 0; type < 3; ++type) {
+        if (times[type].empty()) {
+            continue;
+        }
+        std::cout << std::left << std::setw(10) << names[type] << std::right << std::setw(8) << times[type].size()
+                  << std::setw(12) << percentile(times[type], 0.5) << std::setw(12) << percentile(times[type], 0.95)
+                  << std::setw(12) << percentile(times[type], 1.0)
+                  << std::setw(16) << (double) changedVertices[type] / times[type].size() << std::endl;
+    }
+    std::cout << std::left << std::setw(10) << "full" << std::right << std::setw(8) << fullTimes.size()
+              << std::setw(12) << percentile(fullTimes, 0.5) << std::setw(12) << percentile(fullTimes, 0.95)
+              << std::setw(12) << percentile(fullTimes, 1.0) << std::setw(16) << vertices << std::endl;
+    return 0;
+}
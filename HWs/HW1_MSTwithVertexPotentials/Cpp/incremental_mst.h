@@ -0,0 +1,676 @@
+#ifndef CPP_INCREMENTAL_MST_H
+#define CPP_INCREMENTAL_MST_H
+
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "vertex_costs.h"
+#include "../../../common/graph.h"
+
+/**
+ * Link-cut tree over vertices and edges, an edge is a node of its own between its endpoints carrying its cost,
+ * so the path maximum is the dearest edge on the path.
+ */
+class LinkCutTree {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    explicit LinkCutTree(size_t size) : nodes(size) {
+        for (uint32_t node = 0; node < size; ++node) {
+            nodes[node].best = node;
+        }
+    }
+
+    void setValue(uint32_t node, uint32_t value) {
+        access(node);
+        splay(node);
+        nodes[node].value = value;
+        update(node);
+    }
+
+    void link(uint32_t a, uint32_t b) {
+        makeRoot(a);
+        nodes[a].parent = b;
+    }
+
+    /**
+     * @param a, b - adjacent in the represented tree
+     */
+    void cut(uint32_t a, uint32_t b) {
+        makeRoot(a);
+        access(b);
+        splay(b);
+        nodes[b].child[0] = NONE;
+        nodes[a].parent = NONE;
+        update(b);
+    }
+
+    /**
+     * @return node of the greatest value on the path from a to b, which have to be connected
+     */
+    uint32_t pathMax(uint32_t a, uint32_t b) {
+        makeRoot(a);
+        access(b);
+        splay(b);
+        return nodes[b].best;
+    }
+
+private:
+    struct Node {
+        uint32_t child[2] = {NONE, NONE};
+        uint32_t parent = NONE;
+        uint32_t value = 0;
+        uint32_t best = NONE; // node of the greatest value in the splay subtree
+        bool reversed = false;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> path;
+
+    bool isRoot(uint32_t node) const {
+        uint32_t parent = nodes[node].parent;
+        return parent == NONE || (nodes[parent].child[0] != node && nodes[parent].child[1] != node);
+    }
+
+    void push(uint32_t node) {
+        Node &current = nodes[node];
+        if (current.reversed) {
+            std::swap(current.child[0], current.child[1]);
+            for (uint32_t child : current.child) {
+                if (child != NONE) {
+                    nodes[child].reversed = !nodes[child].reversed;
+                }
+            }
+            current.reversed = false;
+        }
+    }
+
+    void update(uint32_t node) {
+        Node &current = nodes[node];
+        current.best = node;
+        for (uint32_t child : current.child) {
+            if (child != NONE && nodes[nodes[child].best].value > nodes[current.best].value) {
+                current.best = nodes[child].best;
+            }
+        }
+    }
+
+    void rotate(uint32_t node) {
+        uint32_t parent = nodes[node].parent, grandparent = nodes[parent].parent;
+        int side = nodes[parent].child[1] == node;
+        if (!isRoot(parent)) {
+            nodes[grandparent].child[nodes[grandparent].child[1] == parent] = node;
+        }
+        nodes[node].parent = grandparent;
+        uint32_t moved = nodes[node].child[!side];
+        nodes[parent].child[side] = moved;
+        if (moved != NONE) {
+            nodes[moved].parent = parent;
+        }
+        nodes[node].child[!side] = parent;
+        nodes[parent].parent = node;
+        update(parent);
+        update(node);
+    }
+
+    void splay(uint32_t node) {
+        path.clear();
+        for (uint32_t current = node; ; current = nodes[current].parent) {
+            path.push_back(current);
+            if (isRoot(current)) {
+                break;
+            }
+        }
+        for (auto current = path.rbegin(); current != path.rend(); ++current) {
+            push(*current);
+        }
+        while (!isRoot(node)) {
+            uint32_t parent = nodes[node].parent;
+            if (!isRoot(parent)) {
+                uint32_t grandparent = nodes[parent].parent;
+                bool zigZig = (nodes[grandparent].child[1] == parent) == (nodes[parent].child[1] == node);
+                rotate(zigZig ? parent : node);
+            }
+            rotate(node);
+        }
+    }
+
+    void access(uint32_t node) {
+        for (uint32_t current = node, last = NONE; current != NONE; last = current, current = nodes[current].parent) {
+            splay(current);
+            nodes[current].child[1] = last;
+            update(current);
+        }
+    }
+
+    void makeRoot(uint32_t node) {
+        access(node);
+        splay(node);
+        nodes[node].reversed = !nodes[node].reversed;
+    }
+};
+
+/**
+ * MST cost of the grid kept up to date while vertices with potential are added, changed and removed.
+ *
+ * An added or lowered potential spreads by a BFS only through the vertices whose costs it improves.
+ * A removed or raised potential first finds the vertices left without a neighbour one step closer with the same
+ * potential, level by level from the vertex, and recomputes only those from the vertices around them.
+ *
+ * Then the tree edges that got dearer are cut from the tree and they, the edges that got cheaper and the edges
+ * between the trees left are inserted cheapest first: between two trees an edge links them, within a tree it
+ * replaces the dearest edge on the path between its endpoints when it is cheaper, found in a link-cut tree.
+ * The trees left are told apart by searching from the cut edges until all but the largest one are exhausted,
+ * so an update takes time in the changed edges and the smaller trees, or one pass when those are too large.
+ */
+class IncrementalMST {
+public:
+    /**
+     * @param potentials - potentialCount x {vertex, potential}
+     * @param extraEdges - extraEdgeCount x {from, to}
+     */
+    IncrementalMST(uint32_t rows, uint32_t columns, const uint32_t *potentials, uint32_t potentialCount,
+                   const uint32_t *extraEdges, uint32_t extraEdgeCount)
+            : vertexCount(rows * columns), tree(0) {
+        std::vector<InputEdge<uint32_t, uint32_t>> inputEdges;
+        for (uint32_t row = 0; row < rows; ++row) {
+            for (uint32_t col = 0; col < columns; ++col) {
+                uint32_t index = row * columns + col;
+                if (col + 1 < columns) {
+                    addEdge(inputEdges, index, index + 1);
+                }
+                if (row + 1 < rows) {
+                    addEdge(inputEdges, index, index + columns);
+                }
+            }
+        }
+        for (size_t i = 0; i < extraEdgeCount; ++i) {
+            addEdge(inputEdges, extraEdges[2 * i], extraEdges[2 * i + 1]);
+        }
+        graph = build_undirected(vertexCount, inputEdges);
+        std::vector<InputEdge<uint32_t, uint32_t>>().swap(inputEdges);
+        tree = LinkCutTree(vertexCount + edges.size());
+        inTree.assign(edges.size(), false);
+        vertexStamp.assign(vertexCount, 0);
+        edgeStamp.assign(edges.size(), 0);
+        treeOf.assign(vertexCount, 0);
+        treeStamp.assign(vertexCount, 0);
+
+        costs.assign(vertexCount, UNREACHED);
+        std::vector<std::pair<uint32_t, uint32_t>> sources;
+        for (size_t i = 0; i < potentialCount; ++i) {
+            costs[potentials[2 * i]] = {0, potentials[2 * i + 1]};
+        }
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            if (costs[vertex].edge_distance_to_potential == 0) {
+                sources.emplace_back(costs[vertex].potential, vertex);
+            }
+        }
+        std::sort(sources.begin(), sources.end());
+        std::vector<uint32_t> sortedSources;
+        for (const std::pair<uint32_t, uint32_t> &source : sources) {
+            sortedSources.push_back(source.second);
+        }
+        breadth_first_search(graph, sortedSources, [this](uint32_t from, const Graph::Edge &edge) {
+            costs[edge.to] = {costs[from].edge_distance_to_potential + 1, costs[from].potential};
+        });
+
+        std::vector<uint32_t> order(edges.size());
+        for (uint32_t id = 0; id < edges.size(); ++id) {
+            edges[id].cost = getEdgeCost(costs[edges[id].from], costs[edges[id].to]);
+            tree.setValue(edgeNode(id), edges[id].cost);
+            order[id] = id;
+        }
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return edges[a].cost < edges[b].cost; });
+        std::vector<uint32_t> component(vertexCount);
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            component[vertex] = vertex;
+        }
+        auto find = [&component](uint32_t vertex) {
+            while (component[vertex] != vertex) {
+                component[vertex] = component[component[vertex]];
+                vertex = component[vertex];
+            }
+            return vertex;
+        };
+        for (uint32_t id : order) {
+            uint32_t a = find(edges[id].from), b = find(edges[id].to);
+            if (a != b) {
+                component[std::max(a, b)] = std::min(a, b);
+                addToTree(id);
+            }
+        }
+    }
+
+    uint64_t cost() const {
+        return treeCost;
+    }
+
+    /**
+     * Vertices whose costs changed in the last update.
+     */
+    size_t changedVertices() const {
+        return changed.size();
+    }
+
+    /**
+     * Adds a vertex with potential or changes its potential.
+     */
+    void setPotential(uint32_t vertex, uint32_t potential) {
+        if (costs[vertex].edge_distance_to_potential == 0 && costs[vertex].potential < potential) {
+            removeCosts(vertex);
+        } else {
+            changed.clear();
+        }
+        addCosts(vertex, potential);
+        updateEdges();
+    }
+
+    void removePotential(uint32_t vertex) {
+        changed.clear();
+        if (costs[vertex].edge_distance_to_potential == 0) {
+            removeCosts(vertex);
+            updateEdges();
+        }
+    }
+
+private:
+    using Graph = CsrGraph<uint32_t, uint32_t>; // edge payload is the edge id
+
+    struct Edge {
+        uint32_t from;
+        uint32_t to;
+        uint32_t cost;
+    };
+
+    // distance, potential, vertex
+    using QueueEntry = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+    const VertexCosts UNREACHED{UINT32_MAX, UINT32_MAX};
+    uint32_t vertexCount;
+    Graph graph;
+    std::vector<Edge> edges;
+    std::vector<bool> inTree;
+    LinkCutTree tree;
+    uint64_t treeCost = 0;
+    std::vector<VertexCosts> costs;
+    // vertices with their costs before the last update
+    std::vector<std::pair<uint32_t, VertexCosts>> changed;
+    // stamps of the current search, compared with stamp, so nothing has to be cleared between searches
+    std::vector<uint32_t> vertexStamp;
+    std::vector<uint32_t> edgeStamp;
+    uint32_t stamp = 0;
+    // trees left after cutting, numbered in the current update when treeStamp is treesStamp
+    std::vector<uint32_t> treeOf;
+    std::vector<uint32_t> treeStamp;
+    uint32_t treesStamp = 0;
+    uint32_t restLabel = 0;
+    std::vector<uint32_t> joined;
+
+    void addEdge(std::vector<InputEdge<uint32_t, uint32_t>> &inputEdges, uint32_t from, uint32_t to) {
+        inputEdges.push_back({from, {to, (uint32_t) edges.size()}});
+        edges.push_back({from, to, 0});
+    }
+
+    uint32_t edgeNode(uint32_t id) const {
+        return vertexCount + id;
+    }
+
+    uint32_t other(uint32_t id, uint32_t vertex) const {
+        return edges[id].from == vertex ? edges[id].to : edges[id].from;
+    }
+
+    static VertexCosts step(const VertexCosts &from) {
+        return {from.edge_distance_to_potential + 1, from.potential};
+    }
+
+    static bool sameCosts(const VertexCosts &a, const VertexCosts &b) {
+        return a.edge_distance_to_potential == b.edge_distance_to_potential && a.potential == b.potential;
+    }
+
+    uint32_t nextStamp() {
+        if (++stamp == 0) {
+            std::fill(vertexStamp.begin(), vertexStamp.end(), 0);
+            std::fill(edgeStamp.begin(), edgeStamp.end(), 0);
+            std::fill(treeStamp.begin(), treeStamp.end(), 0);
+            stamp = 1;
+        }
+        return stamp;
+    }
+
+    void setCosts(uint32_t vertex, const VertexCosts &newCosts) {
+        if (vertexStamp[vertex] != stamp) {
+            vertexStamp[vertex] = stamp;
+            changed.emplace_back(vertex, costs[vertex]);
+        }
+        costs[vertex] = newCosts;
+    }
+
+    /**
+     * BFS from the vertex through the vertices whose costs the potential improves,
+     * they are reached in the order of their distance from the vertex.
+     */
+    void addCosts(uint32_t vertex, uint32_t potential) {
+        if (changed.empty()) {
+            nextStamp();
+        }
+        VertexCosts source{0, potential};
+        if (!lessCosts(source, costs[vertex])) {
+            return;
+        }
+        setCosts(vertex, source);
+        std::vector<uint32_t> queue{vertex};
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t current = queue[head];
+            VertexCosts candidate = step(costs[current]);
+            for (const Graph::Edge &edge : graph.neighbors(current)) {
+                if (lessCosts(candidate, costs[edge.to])) {
+                    setCosts(edge.to, candidate);
+                    queue.push_back(edge.to);
+                }
+            }
+        }
+    }
+
+    /**
+     * A vertex loses its costs when none of its neighbours one step closer with the same potential keeps them,
+     * such neighbours are decided a level earlier. The vertices that lost their costs are then recomputed
+     * by a Dijkstra seeded from the vertices around them.
+     */
+    void removeCosts(uint32_t vertex) {
+        nextStamp();
+        std::vector<uint32_t> lost{vertex};
+        setCosts(vertex, costs[vertex]);
+        for (size_t head = 0; head < lost.size(); ++head) {
+            uint32_t current = lost[head];
+            VertexCosts child = step(costs[current]);
+            for (const Graph::Edge &edge : graph.neighbors(current)) {
+                uint32_t candidate = edge.to;
+                if (vertexStamp[candidate] == stamp || !sameCosts(costs[candidate], child)) {
+                    continue;
+                }
+                bool supported = false;
+                for (const Graph::Edge &support : graph.neighbors(candidate)) {
+                    supported |= vertexStamp[support.to] != stamp
+                                 && costs[support.to].edge_distance_to_potential != UINT32_MAX
+                                 && sameCosts(step(costs[support.to]), child);
+                }
+                if (!supported) {
+                    setCosts(candidate, child);
+                    lost.push_back(candidate);
+                }
+            }
+        }
+
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        for (uint32_t current : lost) {
+            costs[current] = UNREACHED;
+        }
+        for (uint32_t current : lost) {
+            for (const Graph::Edge &edge : graph.neighbors(current)) {
+                const VertexCosts &neighbor = costs[edge.to];
+                if (vertexStamp[edge.to] != stamp && neighbor.edge_distance_to_potential != UINT32_MAX
+                        && lessCosts(step(neighbor), costs[current])) {
+                    costs[current] = step(neighbor);
+                }
+            }
+            if (costs[current].edge_distance_to_potential != UINT32_MAX) {
+                queue.emplace(costs[current].edge_distance_to_potential, costs[current].potential, current);
+            }
+        }
+        while (!queue.empty()) {
+            uint32_t distance, potential, current;
+            std::tie(distance, potential, current) = queue.top();
+            queue.pop();
+            if (costs[current].edge_distance_to_potential != distance || costs[current].potential != potential) {
+                continue;
+            }
+            VertexCosts candidate = step(costs[current]);
+            for (const Graph::Edge &edge : graph.neighbors(current)) {
+                if (vertexStamp[edge.to] == stamp && lessCosts(candidate, costs[edge.to])) {
+                    costs[edge.to] = candidate;
+                    queue.emplace(candidate.edge_distance_to_potential, candidate.potential, edge.to);
+                }
+            }
+        }
+    }
+
+    /**
+     * Gives the edges of the changed vertices their new costs. The dearer tree edges leave the tree. An edge outside
+     * the tree that did not get cheaper and joins two vertices of the same remaining tree is still the dearest on its
+     * old cycle, so only the cheaper edges, the removed ones and the edges between the remaining trees are inserted,
+     * cheapest first.
+     */
+    void updateEdges() {
+        uint32_t edgesStamp = nextStamp();
+        std::vector<uint32_t> candidates, cutEdges;
+        for (const std::pair<uint32_t, VertexCosts> &vertex : changed) {
+            if (sameCosts(costs[vertex.first], vertex.second)) {
+                continue;
+            }
+            for (const Graph::Edge &edge : graph.neighbors(vertex.first)) {
+                uint32_t id = edge.payload;
+                if (edgeStamp[id] == edgesStamp) {
+                    continue;
+                }
+                edgeStamp[id] = edgesStamp;
+                uint32_t oldCost = edges[id].cost, newCost = getEdgeCost(costs[edges[id].from], costs[edges[id].to]);
+                if (newCost == oldCost) {
+                    continue;
+                }
+                if (inTree[id] && newCost > oldCost) {
+                    removeFromTree(id);
+                    cutEdges.push_back(id);
+                    candidates.push_back(id);
+                } else if (inTree[id]) {
+                    treeCost -= oldCost - newCost;
+                } else if (newCost < oldCost) {
+                    candidates.push_back(id);
+                }
+                edges[id].cost = newCost;
+                tree.setValue(edgeNode(id), newCost);
+            }
+        }
+        joined.clear();
+        if (!cutEdges.empty()) {
+            numberTrees(cutEdges, candidates);
+        }
+        std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) { return edges[a].cost < edges[b].cost; });
+        for (uint32_t id : candidates) {
+            insertEdge(id);
+        }
+    }
+
+    /**
+     * Numbers the trees of the forest left after cutting the dearer tree edges and adds the edges between them to
+     * the candidates. The trees around the cut edges are searched at once until a single one is left unexhausted,
+     * the rest, so only the edges of the numbered trees are looked at. When the searches take too long all trees
+     * are numbered in one pass over the graph instead.
+     * joined tells which trees got linked since, cheaper edges replacing dearer ones never change what is connected.
+     */
+    void numberTrees(const std::vector<uint32_t> &cutEdges, std::vector<uint32_t> &candidates) {
+        std::vector<uint32_t> numbered;
+        if (numberSmallTrees(cutEdges, vertexCount / 8, numbered)) {
+            restLabel = (uint32_t) joined.size();
+            joined.push_back(restLabel);
+            for (uint32_t vertex : numbered) {
+                for (const Graph::Edge &edge : graph.neighbors(vertex)) {
+                    if (!inTree[edge.payload] && treeLabel(vertex) != treeLabel(edge.to)) {
+                        candidates.push_back(edge.payload);
+                    }
+                }
+            }
+            return;
+        }
+        numberAllTrees();
+        for (uint32_t id = 0; id < edges.size(); ++id) {
+            // changed edges come again, inserting an edge already in place changes nothing
+            if (!inTree[id] && treeOf[edges[id].from] != treeOf[edges[id].to]) {
+                candidates.push_back(id);
+            }
+        }
+    }
+
+    /**
+     * Searches from the endpoints of the cut edges over tree edges, one vertex of each search in turn.
+     * Searches meeting in a tree are merged, the smaller into the larger, an exhausted search is a whole tree
+     * and gets numbered. The last search left is the rest, its vertices stay unnumbered.
+     * @param budget - vertices expanded before giving up
+     * @return whether all trees but the rest got numbered
+     */
+    bool numberSmallTrees(const std::vector<uint32_t> &cutEdges, size_t budget, std::vector<uint32_t> &numbered) {
+        uint32_t searchStamp = nextStamp();
+        treesStamp = nextStamp();
+        std::vector<std::vector<uint32_t>> queues;
+        std::vector<size_t> heads;
+        std::vector<uint32_t> active;
+        for (uint32_t id : cutEdges) {
+            for (uint32_t vertex : {edges[id].from, edges[id].to}) {
+                if (vertexStamp[vertex] != searchStamp) {
+                    vertexStamp[vertex] = searchStamp;
+                    treeOf[vertex] = (uint32_t) queues.size();
+                    active.push_back((uint32_t) queues.size());
+                    queues.push_back({vertex});
+                    heads.push_back(0);
+                }
+            }
+        }
+        size_t turn = 0;
+        while (active.size() > 1) {
+            if (budget-- == 0) {
+                return false;
+            }
+            turn = turn < active.size() ? turn : 0;
+            uint32_t search = active[turn];
+            uint32_t met = search;
+            for (const Graph::Edge &edge : graph.neighbors(queues[search][heads[search]++])) {
+                if (!inTree[edge.payload]) {
+                    continue;
+                }
+                if (vertexStamp[edge.to] != searchStamp) {
+                    vertexStamp[edge.to] = searchStamp;
+                    treeOf[edge.to] = search;
+                    queues[search].push_back(edge.to);
+                } else if (treeOf[edge.to] != search) {
+                    met = treeOf[edge.to];
+                    break;
+                }
+            }
+            if (met != search) {
+                uint32_t into = queues[met].size() >= queues[search].size() ? met : search;
+                uint32_t from = into == met ? search : met;
+                // the vertex that met is expanded again to find the rest of its neighbours
+                if (into == search) {
+                    --heads[search];
+                }
+                for (uint32_t vertex : queues[from]) {
+                    treeOf[vertex] = into;
+                    queues[into].push_back(vertex);
+                }
+                std::vector<uint32_t>().swap(queues[from]);
+                retire(active, from);
+            } else if (heads[search] == queues[search].size()) {
+                uint32_t label = (uint32_t) joined.size();
+                joined.push_back(label);
+                for (uint32_t vertex : queues[search]) {
+                    treeOf[vertex] = label;
+                    treeStamp[vertex] = treesStamp;
+                    numbered.push_back(vertex);
+                }
+                retire(active, search);
+            } else {
+                ++turn;
+            }
+        }
+        return true;
+    }
+
+    static void retire(std::vector<uint32_t> &active, uint32_t search) {
+        *std::find(active.begin(), active.end(), search) = active.back();
+        active.pop_back();
+    }
+
+    void numberAllTrees() {
+        treesStamp = nextStamp();
+        joined.clear();
+        std::vector<uint32_t> queue;
+        for (uint32_t root = 0; root < vertexCount; ++root) {
+            if (treeStamp[root] == treesStamp) {
+                continue;
+            }
+            uint32_t label = (uint32_t) joined.size();
+            joined.push_back(label);
+            treeOf[root] = label;
+            treeStamp[root] = treesStamp;
+            queue.assign(1, root);
+            for (size_t head = 0; head < queue.size(); ++head) {
+                for (const Graph::Edge &edge : graph.neighbors(queue[head])) {
+                    if (inTree[edge.payload] && treeStamp[edge.to] != treesStamp) {
+                        treeOf[edge.to] = label;
+                        treeStamp[edge.to] = treesStamp;
+                        queue.push_back(edge.to);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Vertices of trees that are not numbered belong to the rest.
+     */
+    uint32_t treeLabel(uint32_t vertex) const {
+        return treeStamp[vertex] == treesStamp ? treeOf[vertex] : restLabel;
+    }
+
+    uint32_t joinedTree(uint32_t label) {
+        while (joined[label] != label) {
+            joined[label] = joined[joined[label]];
+            label = joined[label];
+        }
+        return label;
+    }
+
+    /**
+     * Links an edge between two trees, within a tree it replaces the dearest edge on the path when it is cheaper.
+     * Without numbered trees the tree spans everything.
+     */
+    void insertEdge(uint32_t id) {
+        uint32_t from = edges[id].from, to = edges[id].to;
+        if (from == to) {
+            return;
+        }
+        if (!joined.empty()) {
+            uint32_t a = joinedTree(treeLabel(from)), b = joinedTree(treeLabel(to));
+            if (a != b) {
+                joined[std::max(a, b)] = std::min(a, b);
+                addToTree(id);
+                return;
+            }
+        }
+        uint32_t dearest = tree.pathMax(from, to);
+        if (dearest >= vertexCount && edges[dearest - vertexCount].cost > edges[id].cost) {
+            removeFromTree(dearest - vertexCount);
+            addToTree(id);
+        }
+    }
+
+    void addToTree(uint32_t id) {
+        inTree[id] = true;
+        treeCost += edges[id].cost;
+        tree.link(edges[id].from, edgeNode(id));
+        tree.link(edgeNode(id), edges[id].to);
+    }
+
+    void removeFromTree(uint32_t id) {
+        inTree[id] = false;
+        treeCost -= edges[id].cost;
+        tree.cut(edges[id].from, edgeNode(id));
+        tree.cut(edgeNode(id), edges[id].to);
+    }
+};
+
+#endif //CPP_INCREMENTAL_MST_H
@@ -2,24 +2,24 @@
 #include <cstdint>
 #include <vector>
 #include <set>
-#include <list>
-#include <unordered_map>
+#include <functional>
 #include <algorithm>
-#include <queue>
 #include <cstdlib>
+#include <string>
+#include "../../../common/graph.h"
+#include "../../../common/instrumentation.h"
+#include "../../../common/memory_resource.h"
+#include "../../../common/batch.h"
+#include "../../../common/binary_input.h"
+#include "vertex_costs.h"
+#include "banded_mst.h"
 
 
-struct VertexCosts {
-    uint32_t edge_distance_to_potential;
-    uint32_t potential;
-};
-
 class VertexGrid {
 public:
     uint32_t rows;
     uint32_t columns;
     std::vector<VertexCosts> costGrid;
-    std::unordered_map<uint64_t, uint64_t> additionalEdges{};
 
     VertexGrid(uint32_t rows, uint32_t columns) : rows(rows), columns(columns){
         costGrid.resize(rows * columns);
@@ -40,81 +40,58 @@ public:
     }
 };
 
-class Graph {
-public:
-    uint64_t vertices;
-    std::vector<std::list<std::pair<uint64_t, uint32_t>>> adjacency_list; //pair (node's linear index, cost)
-
-    explicit Graph(uint64_t vertices) : vertices(vertices) {
-        adjacency_list.resize(vertices);
-    }
-
-    Graph(Graph&& other) = default;
-
-    void add_edge(uint64_t from, uint64_t to, uint32_t cost) {
-        adjacency_list[from].emplace_back(to, cost);
-    }
-
-};
-
-uint32_t getEdgeCost(uint32_t d1, uint32_t d2, uint32_t pot1, uint32_t pot2) {
-    int64_t potDiff = (int64_t) pot1 - (int64_t) pot2;
-    return d1 + d2 + (uint32_t) std::abs(potDiff);
-}
-
-Graph findPotentialsCreateGraph(VertexGrid& grid, const std::vector<uint64_t>& sortedVerticesWithPotential) {
-    std::array<std::pair<int8_t, int8_t>, 4> offsets = {{{-1, 0}, {0, -1}, {0, 1}, {1, 0}}};
-    std::queue<uint64_t> queue;
-    std::vector<bool> computed(grid.rows * grid.columns, false);
-    Graph graph(grid.rows * grid.columns);
-    auto processNeighbor = [&](const VertexCosts& current, uint64_t currentCoords, uint64_t neighborCoords) {
-        if (!computed[neighborCoords]) {
-            grid.costGrid[neighborCoords] = {current.edge_distance_to_potential+1, current.potential};
-            queue.push(neighborCoords);
-            computed[neighborCoords] = true;
-        }
-
-        VertexCosts neighbor = grid.costGrid[neighborCoords];
-        uint32_t edge_cost = getEdgeCost(current.edge_distance_to_potential,
-                                         neighbor.edge_distance_to_potential,
-                                         current.potential,
-                                         neighbor.potential);
-        graph.add_edge(currentCoords, neighborCoords, edge_cost);
-    };
-
-    for(uint64_t vertex: sortedVerticesWithPotential) {
-        computed[vertex] = true;
-        queue.push(vertex);
-    }
-
-    while (!queue.empty()) {
-        uint64_t currentCoords = queue.front();
-        queue.pop();
-        int64_t row = grid.getRow(currentCoords);
-        int64_t col = grid.getCol(currentCoords);
-
-        VertexCosts current = grid.costGrid[currentCoords];
-
-        for (auto& offset: offsets) {
-            int64_t nRow = row + offset.first;
-            int64_t nCol = col + offset.second;
-            if ( (nRow >= 0) && (nRow < grid.rows) && (nCol >= 0) && (nCol < grid.columns) ) {
-                processNeighbor(current, currentCoords, grid.getIdx((uint32_t) nRow, (uint32_t) nCol));
+using Graph = CsrGraph<uint32_t, uint32_t>; //edge payload is the cost
+
+/**
+ * Grid edges to the right and down neighbour of every vertex, cost is filled in by assignEdgeCosts
+ */
+std::vector<InputEdge<uint32_t, uint32_t>> gridEdges(VertexGrid &grid) {
+    std::vector<InputEdge<uint32_t, uint32_t>> edges;
+    edges.reserve(2 * (uint64_t) grid.rows * grid.columns);
+    for (uint32_t row = 0; row < grid.rows; ++row) {
+        for (uint32_t col = 0; col < grid.columns; ++col) {
+            uint32_t index = (uint32_t) grid.getIdx(row, col);
+            if (col + 1 < grid.columns) {
+                edges.push_back({index, {index + 1, 0}});
+            }
+            if (row + 1 < grid.rows) {
+                edges.push_back({index, {index + grid.columns, 0}});
             }
         }
+    }
+    return edges;
+}
 
-        if (grid.additionalEdges.find(currentCoords) != grid.additionalEdges.end()) {
-            processNeighbor(current, currentCoords, grid.additionalEdges[currentCoords]);
+/**
+ * Multi-source BFS from the vertices with potential in ascending order of potential, a vertex takes its
+ * distance and potential from the vertex that discovered it, so the first discoverer has the least potential.
+ * Afterwards every edge gets its cost.
+ */
+void assignEdgeCosts(VertexGrid &grid, Graph &graph, const std::vector<uint32_t> &sortedVerticesWithPotential) {
+    breadth_first_search(graph, sortedVerticesWithPotential, [&grid](uint32_t from, const Graph::Edge &edge) {
+        const VertexCosts &current = grid.costGrid[from];
+        grid.costGrid[edge.to] = {current.edge_distance_to_potential + 1, current.potential};
+    });
+
+    for (uint32_t vertex = 0; vertex < graph.vertex_count(); ++vertex) {
+        const VertexCosts &current = grid.costGrid[vertex];
+        for (Graph::Edge &edge : graph.neighbors(vertex)) {
+            const VertexCosts &neighbor = grid.costGrid[edge.to];
+            edge.payload = getEdgeCost(current.edge_distance_to_potential,
+                                       neighbor.edge_distance_to_potential,
+                                       current.potential,
+                                       neighbor.potential);
         }
     }
-
-    return graph;
 }
 
 uint64_t primMSTcost(const Graph& graph) {
-    std::vector<uint32_t> costToPred(graph.vertices, UINT32_MAX);
-    std::vector<bool> visited(graph.vertices, false);
-    std::set<std::pair<uint32_t, uint64_t>> priorityQueue;
+    std::vector<uint32_t> costToPred(graph.vertex_count(), UINT32_MAX);
+    std::vector<bool> visited(graph.vertex_count(), false);
+    // queue nodes are recycled through the pool, erase and insert alternate on every relaxation
+    PoolResource queueNodes;
+    using QueueEntry = std::pair<uint32_t, uint64_t>;
+    std::set<QueueEntry, std::less<QueueEntry>, ResourceAllocator<QueueEntry>> priorityQueue(std::less<QueueEntry>(), &queueNodes);
 
     uint64_t MSTcost = 0;
 
@@ -131,9 +108,9 @@ uint64_t primMSTcost(const Graph& graph) {
         visited[node] = true;
 
         MSTcost += final_cost;
-        for(const std::pair<uint64_t, uint32_t>& neighborPair: graph.adjacency_list[node]) {
-            uint64_t neighborCoords = neighborPair.first;
-            uint32_t neighborEdgeCost = neighborPair.second;
+        for(const Graph::Edge& edge: graph.neighbors((uint32_t) node)) {
+            uint64_t neighborCoords = edge.to;
+            uint32_t neighborEdgeCost = edge.payload;
             if (!visited[neighborCoords]) {
                 if (costToPred[neighborCoords] > neighborEdgeCost) {
                     if (costToPred[neighborCoords] != UINT32_MAX) {
@@ -148,36 +125,128 @@ uint64_t primMSTcost(const Graph& graph) {
     return MSTcost;
 }
 
-int main() {
-    uint32_t rows{}, cols{}, potentialVertexCount{}, addedEdges{};
-    std::cin >> rows >> cols >> potentialVertexCount >> addedEdges;
+struct Options {
+    uint64_t memoryCap = 0; // bytes, 0 keeps the whole grid in memory
+};
+
+/**
+ * @param potentials - potentialCount x {vertex, potential}
+ * @param extraEdges - extraEdgeCount x {from, to}
+ * @return 0, or 1 when the banded mode could not use its temporary file
+ */
+int solve(uint32_t rows, uint32_t cols, const uint32_t *potentials, uint32_t potentialCount,
+          const uint32_t *extraEdges, uint32_t extraEdgeCount, const Options &options, std::ostream &output) {
+    if (options.memoryCap > 0) {
+        PROFILE_SCOPE("banded mst");
+        BandedMST banded(rows, cols, potentials, potentialCount, extraEdges, extraEdgeCount, options.memoryCap);
+        uint64_t MSTcost;
+        if (!banded.run(MSTcost)) {
+            std::cerr << "hw1: cannot use a temporary file for the banded mode" << std::endl;
+            return 1;
+        }
+        output << MSTcost << std::endl;
+        return 0;
+    }
+    PROFILE_START(phase, "build graph");
     VertexGrid grid(rows, cols);
     std::vector<std::pair<uint32_t, uint64_t>> verticesWithPotential;
-    verticesWithPotential.reserve(potentialVertexCount);
-
-    for(size_t i = 0; i < potentialVertexCount; ++i) {
-        uint32_t row{}, col{}, potential{};
-        std::cin >> row >> col >> potential;
-        --row;
-        --col;
-        grid.costGrid[grid.getIdx(row, col)] = {0, potential};
-        verticesWithPotential.emplace_back(potential, grid.getIdx(row, col));
+    verticesWithPotential.reserve(potentialCount);
+    for (size_t i = 0; i < potentialCount; ++i) {
+        uint32_t vertex = potentials[2 * i], potential = potentials[2 * i + 1];
+        grid.costGrid[vertex] = {0, potential};
+        verticesWithPotential.emplace_back(potential, vertex);
     }
 
-    for (size_t i=0; i < addedEdges; ++i) {
-        uint32_t fRow{}, fCol{}, tRow{}, tCol{};
-        std::cin >> fRow >> fCol >> tRow >> tCol;
-        uint64_t fromPos = grid.getIdx(fRow-1, fCol-1);
-        uint64_t toPos = grid.getIdx(tRow-1, tCol-1);
-        grid.additionalEdges[fromPos] = toPos;
-        grid.additionalEdges[toPos] = fromPos;
+    std::vector<InputEdge<uint32_t, uint32_t>> edges = gridEdges(grid);
+    for (size_t i = 0; i < extraEdgeCount; ++i) {
+        edges.push_back({extraEdges[2 * i], {extraEdges[2 * i + 1], 0}});
     }
+    Graph graph = build_undirected(rows * cols, edges);
+    std::vector<InputEdge<uint32_t, uint32_t>>().swap(edges);
 
+    PROFILE_NEXT(phase, "potentials and costs");
     std::sort(verticesWithPotential.begin(), verticesWithPotential.end());
-    std::vector<uint64_t> sortedVerticesPotential;
-    std::transform(verticesWithPotential.begin(), verticesWithPotential.end(), std::back_inserter(sortedVerticesPotential), [](std::pair<uint32_t, uint64_t>& el) {return el.second;});
+    std::vector<uint32_t> sortedVerticesPotential;
+    std::transform(verticesWithPotential.begin(), verticesWithPotential.end(), std::back_inserter(sortedVerticesPotential), [](std::pair<uint32_t, uint64_t>& el) {return (uint32_t) el.second;});
+
+    assignEdgeCosts(grid, graph, sortedVerticesPotential);
+
+    PROFILE_NEXT(phase, "prim");
+    output << primMSTcost(graph) << std::endl;
+    return 0;
+}
+
+/**
+ * Text input, rows and columns are 1-based, it is parsed into the arrays of the binary format.
+ */
+int solve(std::istream &input, const Options &options, std::ostream &output) {
+    std::vector<uint32_t> potentials, extraEdges;
+    uint32_t rows{}, cols{}, potentialVertexCount{}, addedEdges{};
+    {
+        PROFILE_SCOPE("parse");
+        input >> rows >> cols >> potentialVertexCount >> addedEdges;
+        potentials.reserve(2 * (size_t) potentialVertexCount);
+        for (size_t i = 0; i < potentialVertexCount; ++i) {
+            uint32_t row{}, col{}, potential{};
+            input >> row >> col >> potential;
+            potentials.push_back((row - 1) * cols + col - 1);
+            potentials.push_back(potential);
+        }
+        extraEdges.reserve(2 * (size_t) addedEdges);
+        for (size_t i = 0; i < addedEdges; ++i) {
+            uint32_t fRow{}, fCol{}, tRow{}, tCol{};
+            input >> fRow >> fCol >> tRow >> tCol;
+            extraEdges.push_back((fRow - 1) * cols + fCol - 1);
+            extraEdges.push_back((tRow - 1) * cols + tCol - 1);
+        }
+    }
+    return solve(rows, cols, potentials.data(), potentialVertexCount, extraEdges.data(), addedEdges, options, output);
+}
+
+int solve(const BinaryInput &input, const Options &options, std::ostream &output) {
+    uint32_t potentialCount = input.count(2);
+    return solve(input.count(0), input.count(1), input.array(0), potentialCount,
+                 input.array(2 * (uint64_t) potentialCount), input.count(3), options, output);
+}
 
-    Graph graph = findPotentialsCreateGraph(grid, sortedVerticesPotential);
+/**
+ * Binary input when data starts with the binary magic, text otherwise.
+ */
+int solve(const char *data, size_t size, const Options &options, std::ostream &output) {
+    if (!is_binary_input(data, size)) {
+        BufferInput input(data, size);
+        return solve(input, options, output);
+    }
+    BinaryInput binary;
+    if (!binary.open(data, size, BinaryTask::HW1)) {
+        std::cerr << "hw1: invalid binary input" << std::endl;
+        return 1;
+    }
+    return solve(binary, options, output);
+}
 
-    std::cout << primMSTcost(graph) << std::endl;
-}
\ No newline at end of file
+/**
+ * usage: hw1 [--memory-cap MiB] < input, or hw1 [--memory-cap MiB] --batch [--jobs N] [input...], see batch.h
+ * Input is text or binary, see binary_input.h.
+ * --memory-cap computes the MST in bands of rows that fit in the cap with the costs in a temporary file,
+ * see banded_mst.h, binary input is then read in place
+ */
+int main(int argc, char *argv[]) {
+    Options options;
+    BatchOptions batch = parse_batch_options(argc, argv);
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--memory-cap") {
+            options.memoryCap = std::strtoull(argv[++i], nullptr, 10) << 20;
+        }
+    }
+    if (batch.enabled) {
+        return run_batch(batch, [&options](std::vector<char> &buffer, std::ostream &output) {
+            solve(buffer.data(), buffer.size(), options, output);
+        });
+    }
+    InputFile file;
+    if (load_binary_stdin(file)) {
+        return solve(file.data(), file.size(), options, std::cout);
+    }
+    return solve(std::cin, options, std::cout);
+}
@@ -0,0 +1,31 @@
+#ifndef CPP_VERTEX_COSTS_H
+#define CPP_VERTEX_COSTS_H
+
+#include <cstdint>
+#include <cstdlib>
+
+struct VertexCosts {
+    uint32_t edge_distance_to_potential;
+    uint32_t potential;
+};
+
+inline uint32_t getEdgeCost(uint32_t d1, uint32_t d2, uint32_t pot1, uint32_t pot2) {
+    int64_t potDiff = (int64_t) pot1 - (int64_t) pot2;
+    return d1 + d2 + (uint32_t) std::abs(potDiff);
+}
+
+inline uint32_t getEdgeCost(const VertexCosts &a, const VertexCosts &b) {
+    return getEdgeCost(a.edge_distance_to_potential, b.edge_distance_to_potential, a.potential, b.potential);
+}
+
+/**
+ * The multi-source BFS gives every vertex the least potential among the nearest vertices with potential,
+ * because the queue stays sorted by potential within every distance, so the costs of a vertex are the
+ * lexicographic minimum of {distance, potential} over the vertices with potential and any relaxation order works.
+ */
+inline bool lessCosts(const VertexCosts &a, const VertexCosts &b) {
+    return a.edge_distance_to_potential < b.edge_distance_to_potential
+           || (a.edge_distance_to_potential == b.edge_distance_to_potential && a.potential < b.potential);
+}
+
+#endif //CPP_VERTEX_COSTS_H
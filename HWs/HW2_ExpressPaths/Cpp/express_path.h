@@ -0,0 +1,114 @@
+#ifndef HW2_EXPRESS_PATH_H
+#define HW2_EXPRESS_PATH_H
+
+#include <cstdint>
+#include <vector>
+#include <list>
+#include <tuple>
+#include <utility>
+#include "scc.h"
+#include "external_scc.h"
+
+/**
+ * Find longest maximum cost express path.
+ * @param graph - CsrGraph, or DiskGraph of external_scc.h
+ * @param topological_order - of the vertices, or any order with the components in topological order
+ * @return pair of (cost of the path, length of the path)
+ */
+template <typename G, typename Order>
+std::pair<uint32_t, uint32_t> find_maximum_cost_longest_express_path(const G &graph,
+                                                                     const std::vector<int32_t> &component,
+                                                                     const std::vector<uint32_t> &component_sizes,
+                                                                     const Order &topological_order) {
+    uint32_t maxPathCost = 0;
+    uint32_t maxPathLength = 0;
+
+    std::vector<uint32_t> pathCostTo(graph.vertex_count());
+    std::vector<uint32_t> pathLenTo(graph.vertex_count(), 0);
+    std::vector<bool> visited(graph.vertex_count(), false); //maybe unnecessary
+    for (uint64_t v = 0; v < graph.vertex_count(); v++) {
+        pathCostTo[v] = component_sizes[component[v]];
+    }
+
+    for (uint32_t vertex : topological_order) {
+        visited[vertex] = true;
+        // a path as costly but not longer must not shorten the best one, the order of the vertices would matter
+        if (pathLenTo[vertex] > 0 && (pathCostTo[vertex] > maxPathCost
+                                      || (pathCostTo[vertex] == maxPathCost && pathLenTo[vertex] > maxPathLength))) {
+            maxPathCost = pathCostTo[vertex];
+            maxPathLength = pathLenTo[vertex];
+        }
+
+        for (const typename G::Edge &edge : graph.neighbors(vertex)) {
+            uint32_t neighbor = edge.to;
+            if (!visited[neighbor]
+                && component[vertex] != component[neighbor]
+                && component_sizes[component[neighbor]] >= component_sizes[component[vertex]]) {
+                uint32_t costToNeighbor = pathCostTo[vertex] + component_sizes[component[neighbor]];
+                uint32_t lenToNeighbor = pathLenTo[vertex] + 1;
+                if (costToNeighbor > pathCostTo[neighbor]) {
+                    pathCostTo[neighbor] = costToNeighbor;
+                    pathLenTo[neighbor] = lenToNeighbor;
+                } else if (costToNeighbor == pathCostTo[neighbor] && lenToNeighbor > pathLenTo[neighbor]) {
+                    pathLenTo[neighbor] = lenToNeighbor;
+                }
+            }
+        }
+    }
+
+    return std::make_pair(maxPathCost, maxPathLength);
+}
+
+/**
+ * Vertices grouped by component with the components in topological order. Tarjan's algorithm numbers a component
+ * after all the components it reaches, so the order is decreasing component number.
+ */
+inline std::vector<uint32_t> component_layout(const std::vector<int32_t> &component, size_t component_count) {
+    std::vector<uint32_t> starts(component_count + 1, 0);
+    for (int32_t c : component) {
+        starts[component_count - 1 - c]++;
+    }
+    uint32_t total = 0;
+    for (uint32_t &start : starts) {
+        uint32_t count = start;
+        start = total;
+        total += count;
+    }
+    std::vector<uint32_t> layout(component.size());
+    for (uint32_t v = 0; v < component.size(); v++) {
+        layout[starts[component_count - 1 - component[v]]++] = v;
+    }
+    return layout;
+}
+
+/**
+ * Semi-external express path, memory is O(V) plus the memory cap for edges, see external_scc.h.
+ * Tarjan's algorithm runs on the edges laid out by vertex, the dynamic programming on the edges laid out
+ * by component in topological order, which it reads from the disk sequentially.
+ * @return false when a temporary file could not be written or read, or an edge has a vertex out of range
+ */
+inline bool external_express_path(uint32_t vertices, EdgeStream &stream, uint64_t memory_cap, IoStats &stats,
+                                  std::pair<uint32_t, uint32_t> &result) {
+    std::vector<int32_t> component;
+    std::vector<uint32_t> component_sizes;
+    {
+        std::list<uint32_t> topological_ordering;
+        DiskGraph graph(vertices, stats);
+        if (!graph.build(stream, {}, memory_cap)) {
+            return false;
+        }
+        std::tie(component, component_sizes, topological_ordering) = tarjan_scc_topo(graph);
+        if (!graph.ok()) {
+            return false;
+        }
+    }
+    std::vector<uint32_t> layout = component_layout(component, component_sizes.size());
+    DiskGraph graph(vertices, stats);
+    if (!graph.build(stream, layout, memory_cap)) {
+        return false;
+    }
+    result = find_maximum_cost_longest_express_path(graph, component, component_sizes, layout);
+    return graph.ok();
+}
+
+#endif //HW2_EXPRESS_PATH_H
@@ -0,0 +1,93 @@
+#ifndef HW2_EXPRESS_QUERIES_H
+#define HW2_EXPRESS_QUERIES_H
+
+#include <cstdint>
+#include <vector>
+#include <list>
+#include "scc.h"
+
+/**
+ * Cost and length of an express path, a path alone in its vertex has the size of its component as cost and length 0.
+ */
+struct ExpressPath {
+    uint32_t cost;
+    uint32_t length;
+
+    bool better_than(const ExpressPath &other) const {
+        return cost > other.cost || (cost == other.cost && length > other.length);
+    }
+};
+
+/**
+ * Maximum cost longest express paths starting at, ending at and passing through every vertex.
+ * One pass over the topological order finds the best path ending at each vertex, as the HW2 solution does,
+ * one pass in the reverse order the best path starting at each vertex. The best path through a vertex joins
+ * the two, they share only the vertex, so the three answers are stored and a query is a single lookup.
+ */
+class ExpressPathQueries {
+public:
+    ExpressPathQueries(const Graph &graph, const std::vector<int32_t> &component,
+                       const std::vector<uint32_t> &component_sizes, const std::list<uint32_t> &topological_order)
+            : ending(graph.vertex_count()), starting(graph.vertex_count()), passing(graph.vertex_count()) {
+        for (uint32_t v = 0; v < graph.vertex_count(); v++) {
+            ending[v] = starting[v] = {component_sizes[component[v]], 0};
+        }
+        for (uint32_t vertex : topological_order) {
+            for (const Graph::Edge &edge : graph.neighbors(vertex)) {
+                if (express_edge(vertex, edge.to, component, component_sizes)) {
+                    ExpressPath path{ending[vertex].cost + component_sizes[component[edge.to]], ending[vertex].length + 1};
+                    if (path.better_than(ending[edge.to])) {
+                        ending[edge.to] = path;
+                    }
+                }
+            }
+        }
+        for (auto it = topological_order.rbegin(); it != topological_order.rend(); ++it) {
+            uint32_t vertex = *it;
+            for (const Graph::Edge &edge : graph.neighbors(vertex)) {
+                if (express_edge(vertex, edge.to, component, component_sizes)) {
+                    ExpressPath path{starting[edge.to].cost + component_sizes[component[vertex]], starting[edge.to].length + 1};
+                    if (path.better_than(starting[vertex])) {
+                        starting[vertex] = path;
+                    }
+                }
+            }
+        }
+        for (uint32_t v = 0; v < graph.vertex_count(); v++) {
+            passing[v] = {ending[v].cost + starting[v].cost - component_sizes[component[v]],
+                          ending[v].length + starting[v].length};
+        }
+    }
+
+    uint32_t vertex_count() const {
+        return (uint32_t) ending.size();
+    }
+
+    const ExpressPath &starting_at(uint32_t vertex) const {
+        return starting[vertex];
+    }
+
+    const ExpressPath &ending_at(uint32_t vertex) const {
+        return ending[vertex];
+    }
+
+    const ExpressPath &through(uint32_t vertex) const {
+        return passing[vertex];
+    }
+
+    /**
+     * An express path goes between components to one at least as large.
+     */
+    static bool express_edge(uint32_t from, uint32_t to, const std::vector<int32_t> &component,
+                             const std::vector<uint32_t> &component_sizes) {
+        return component[from] != component[to]
+               && component_sizes[component[to]] >= component_sizes[component[from]];
+    }
+
+private:
+    std::vector<ExpressPath> ending;
+    std::vector<ExpressPath> starting;
+    std::vector<ExpressPath> passing;
+};
+
+#endif //HW2_EXPRESS_QUERIES_H
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <list>
+#include <tuple>
+#include <chrono>
+#include "scc.h"
+#include "external_scc.h"
+#include "express_path.h"
+
+/**
+ * Run time and I/O of the semi-external express path against the in-memory one, for memory caps in MiB.
+ * The edges are written to a temporary file first, as when a text input is parsed with a memory cap.
+ * usage: external_benchmark [cap MiB...] < input
+ */
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void print_row(const char *mode, double ms, double edge_mib, const IoStats &stats, std::pair<uint32_t, uint32_t> path) {
+    std::cout << std::left << std::setw(12) << mode << std::right << std::setw(10) << ms << std::setw(12) << edge_mib
+              << std::setw(12) << stats.bytesRead / 1048576.0 << std::setw(12) << stats.bytesWritten / 1048576.0
+              << std::setw(8) << stats.streamPasses << "   " << path.first << " " << path.second << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    std::ios_base::sync_with_stdio(false);
+    uint32_t vertices, edges;
+    std::cin >> vertices >> edges;
+    std::vector<InputEdge<uint32_t>> edge_list(edges);
+    for (InputEdge<uint32_t> &edge : edge_list) {
+        std::cin >> edge.from >> edge.edge.to;
+    }
+    std::vector<uint64_t> caps;
+    for (int i = 1; i < argc; ++i) {
+        caps.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (caps.empty()) {
+        caps = {1, 4, 64};
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "graph " << vertices << " vertices, " << edges << " edges" << std::endl;
+    std::cout << std::left << std::setw(12) << "mode" << std::right << std::setw(10) << "ms" << std::setw(12) << "edge MiB"
+              << std::setw(12) << "read MiB" << std::setw(12) << "written MiB" << std::setw(8) << "passes"
+              << "   path" << std::endl;
+
+    auto start = Clock::now();
+    Graph graph = build_directed(vertices, edge_list.data(), edge_list.data() + edge_list.size());
+    std::vector<int32_t> component;
+    std::vector<uint32_t> component_sizes;
+    std::list<uint32_t> topological_ordering;
+    std::tie(component, component_sizes, topological_ordering) = tarjan_scc_topo(graph);
+    std::pair<uint32_t, uint32_t> expected = find_maximum_cost_longest_express_path(graph, component, component_sizes,
+                                                                                    topological_ordering);
+    print_row("in memory", milliseconds(start), graph.memory_bytes() / 1048576.0, IoStats(), expected);
+
+    for (uint64_t cap : caps) {
+        IoStats stats;
+        EdgeStream stream(stats);
+        if (!stream.append(edge_list.data(), edge_list.size())) {
+            std::cerr << "cannot write a temporary file" << std::endl;
+            return 1;
+        }
+        std::pair<uint32_t, uint32_t> path;
+        start = Clock::now();
+        if (!external_express_path(vertices, stream, cap << 20, stats, path)) {
+            std::cerr << "external express path failed" << std::endl;
+            return 1;
+        }
+        std::string mode = "cap " + std::to_string(cap) + " MiB";
+        print_row(mode.c_str(), milliseconds(start), (double) cap, stats, path);
+        if (path != expected) {
+            std::cerr << "external path differs from the in-memory one" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
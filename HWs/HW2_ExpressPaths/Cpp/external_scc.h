@@ -0,0 +1,319 @@
+#ifndef HW2_EXTERNAL_SCC_H
+#define HW2_EXTERNAL_SCC_H
+
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <unistd.h>
+#include "../../../common/graph.h"
+
+/**
+ * Edge lists kept on disk for graphs whose edges do not fit in memory, only per-vertex state stays in memory.
+ *
+ * EdgeStream is the input edge list read in chunks, from a temporary file written while parsing or from a binary
+ * input in place. DiskGraph distributes the stream into a temporary file with the edges of every vertex together,
+ * vertices in a given layout, taking one pass over the stream per buffer of edges, and reads the file back through
+ * a page cache. It has the interface of CsrGraph that DepthFirstSearch and the express path dynamic programming
+ * use, so Tarjan's algorithm and the dynamic programming run on it unchanged.
+ */
+
+struct IoStats {
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t streamPasses = 0;
+};
+
+class EdgeStream {
+public:
+    static constexpr size_t CHUNK_EDGES = 1 << 16;
+
+    explicit EdgeStream(IoStats &stats) : stats(stats) {}
+
+    EdgeStream(const EdgeStream &) = delete;
+
+    EdgeStream &operator=(const EdgeStream &) = delete;
+
+    ~EdgeStream() {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    /**
+     * Streams edges held elsewhere, such as a mapped binary input, valid while they are.
+     */
+    void assign(const InputEdge<uint32_t> *first, uint64_t count) {
+        mapped = first;
+        edgeCount = count;
+    }
+
+    /**
+     * Appends to the temporary file, created by the first call.
+     * @return false when the file could not be created or written
+     */
+    bool append(const InputEdge<uint32_t> *first, size_t count) {
+        if (file == nullptr && (file = std::tmpfile()) == nullptr) {
+            return false;
+        }
+        edgeCount += count;
+        stats.bytesWritten += count * sizeof(InputEdge<uint32_t>);
+        return std::fwrite(first, sizeof(InputEdge<uint32_t>), count, file) == count;
+    }
+
+    uint64_t size() const {
+        return edgeCount;
+    }
+
+    /**
+     * Calls function(first, count) for consecutive chunks of all edges.
+     * @return false when the file could not be read
+     */
+    template <typename Function>
+    bool for_each_chunk(Function function) {
+        stats.streamPasses++;
+        stats.bytesRead += edgeCount * sizeof(InputEdge<uint32_t>);
+        if (mapped != nullptr || edgeCount == 0) {
+            for (uint64_t done = 0; done < edgeCount; done += CHUNK_EDGES) {
+                function(mapped + done, (size_t) std::min<uint64_t>(CHUNK_EDGES, edgeCount - done));
+            }
+            return true;
+        }
+        if (std::fflush(file) != 0) {
+            return false;
+        }
+        buffer.resize(CHUNK_EDGES);
+        for (uint64_t done = 0; done < edgeCount; done += CHUNK_EDGES) {
+            size_t count = (size_t) std::min<uint64_t>(CHUNK_EDGES, edgeCount - done);
+            size_t bytes = count * sizeof(InputEdge<uint32_t>);
+            if (pread(fileno(file), buffer.data(), bytes, done * sizeof(InputEdge<uint32_t>)) != (ssize_t) bytes) {
+                return false;
+            }
+            function(buffer.data(), count);
+        }
+        return true;
+    }
+
+private:
+    IoStats &stats;
+    const InputEdge<uint32_t> *mapped = nullptr;
+    FILE *file = nullptr;
+    uint64_t edgeCount = 0;
+    std::vector<InputEdge<uint32_t>> buffer;
+};
+
+/**
+ * Adjacency lists in a temporary file, the first edge and the degree of every vertex in memory.
+ * Pages of the file are cached with the clock algorithm, the cache is the only memory held for edges.
+ */
+class DiskGraph {
+public:
+    using Vertex = uint32_t;
+    using Edge = CsrEdge<uint32_t, NoPayload>;
+
+    static constexpr size_t PAGE_EDGES = 1024;
+
+    class EdgeIterator {
+    public:
+        EdgeIterator(const DiskGraph &graph, uint64_t index) : graph(&graph), index(index) {}
+
+        Edge operator*() const {
+            return graph->edge(index);
+        }
+
+        Edge operator[](uint64_t offset) const {
+            return graph->edge(index + offset);
+        }
+
+        EdgeIterator &operator++() {
+            ++index;
+            return *this;
+        }
+
+        bool operator!=(const EdgeIterator &other) const {
+            return index != other.index;
+        }
+
+    private:
+        const DiskGraph *graph;
+        uint64_t index;
+    };
+
+    class Edges {
+    public:
+        Edges(const DiskGraph &graph, uint64_t first, uint32_t count) : graph(graph), first(first), count(count) {}
+
+        EdgeIterator begin() const {
+            return {graph, first};
+        }
+
+        EdgeIterator end() const {
+            return {graph, first + count};
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+    private:
+        const DiskGraph &graph;
+        uint64_t first;
+        uint32_t count;
+    };
+
+    DiskGraph(uint32_t vertices, IoStats &stats) : vertices(vertices), stats(stats) {}
+
+    DiskGraph(const DiskGraph &) = delete;
+
+    DiskGraph &operator=(const DiskGraph &) = delete;
+
+    ~DiskGraph() {
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+    }
+
+    /**
+     * Writes the adjacency lists of the vertices in the order of layout, the vertices in order when it is empty.
+     * Half of the memory cap buffers the edges of a range of vertices while they are picked from a pass over
+     * the stream, the whole cap holds the page cache afterwards.
+     * @return false when the temporary file could not be written or an edge has a vertex out of range
+     */
+    bool build(EdgeStream &stream, const std::vector<uint32_t> &layout, uint64_t memoryCap) {
+        file = std::tmpfile();
+        if (file == nullptr) {
+            return false;
+        }
+        degrees.assign(vertices, 0);
+        bool valid = true;
+        bool read = stream.for_each_chunk([this, &valid](const InputEdge<uint32_t> *edges, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                if (edges[i].from >= vertices || edges[i].edge.to >= vertices) {
+                    valid = false;
+                    return;
+                }
+                degrees[edges[i].from]++;
+            }
+        });
+        if (!read || !valid) {
+            return false;
+        }
+        firsts.resize(vertices);
+        uint64_t total = 0;
+        for (uint32_t position = 0; position < vertices; ++position) {
+            uint32_t vertex = layout.empty() ? position : layout[position];
+            firsts[vertex] = total;
+            total += degrees[vertex];
+        }
+        edgeCount = total;
+        pageCount = (total + PAGE_EDGES - 1) / PAGE_EDGES;
+
+        uint64_t bufferEdges = std::max<uint64_t>(PAGE_EDGES, memoryCap / 2 / sizeof(uint32_t));
+        std::vector<uint64_t> next(firsts);
+        std::vector<uint32_t> buffer;
+        for (uint32_t position = 0; position < vertices;) {
+            uint64_t low = firsts[layout.empty() ? position : layout[position]], high = low;
+            while (position < vertices) {
+                uint32_t vertex = layout.empty() ? position : layout[position];
+                if (high > low && high + degrees[vertex] - low > bufferEdges) {
+                    break;
+                }
+                high += degrees[vertex];
+                position++;
+            }
+            if (high == low) {
+                continue;
+            }
+            buffer.resize(high - low);
+            read = stream.for_each_chunk([this, &next, &buffer, low, high](const InputEdge<uint32_t> *edges, size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t first = firsts[edges[i].from];
+                    if (first >= low && first < high) {
+                        buffer[next[edges[i].from]++ - low] = edges[i].edge.to;
+                    }
+                }
+            });
+            size_t bytes = buffer.size() * sizeof(uint32_t);
+            if (!read || pwrite(fileno(file), buffer.data(), bytes, low * sizeof(uint32_t)) != (ssize_t) bytes) {
+                return false;
+            }
+            stats.bytesWritten += bytes;
+        }
+
+        size_t slots = (size_t) std::max<uint64_t>(1, std::min<uint64_t>(pageCount, memoryCap / (PAGE_EDGES * sizeof(uint32_t))));
+        pages.assign(slots * PAGE_EDGES, 0);
+        slotPages.assign(slots, UINT64_MAX);
+        referenced.assign(slots, false);
+        pageSlots.assign(pageCount, -1);
+        return true;
+    }
+
+    Vertex vertex_count() const {
+        return vertices;
+    }
+
+    uint64_t degree(Vertex vertex) const {
+        return degrees[vertex];
+    }
+
+    Edges neighbors(Vertex vertex) const {
+        return {*this, firsts[vertex], degrees[vertex]};
+    }
+
+    Edge edge(uint64_t index) const {
+        uint64_t page = index / PAGE_EDGES;
+        int32_t slot = pageSlots[page];
+        if (slot < 0) {
+            slot = load(page);
+        }
+        referenced[slot] = true;
+        return Edge{pages[(size_t) slot * PAGE_EDGES + index % PAGE_EDGES]};
+    }
+
+    /**
+     * @return false when a page could not be read, the edges read are then zeros
+     */
+    bool ok() const {
+        return !failed;
+    }
+
+    size_t cache_bytes() const {
+        return pages.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    const uint32_t vertices;
+    IoStats &stats;
+    FILE *file = nullptr;
+    std::vector<uint64_t> firsts;
+    std::vector<uint32_t> degrees;
+    uint64_t edgeCount = 0;
+    uint64_t pageCount = 0;
+    mutable std::vector<uint32_t> pages;
+    mutable std::vector<uint64_t> slotPages;
+    mutable std::vector<bool> referenced;
+    mutable std::vector<int32_t> pageSlots;
+    mutable size_t hand = 0;
+    mutable bool failed = false;
+
+    int32_t load(uint64_t page) const {
+        while (referenced[hand]) {
+            referenced[hand] = false;
+            hand = (hand + 1) % slotPages.size();
+        }
+        size_t slot = hand;
+        hand = (hand + 1) % slotPages.size();
+        if (slotPages[slot] != UINT64_MAX) {
+            pageSlots[slotPages[slot]] = -1;
+        }
+        slotPages[slot] = page;
+        pageSlots[page] = (int32_t) slot;
+        uint64_t first = page * PAGE_EDGES;
+        size_t bytes = (size_t) std::min<uint64_t>(PAGE_EDGES, edgeCount - first) * sizeof(uint32_t);
+        failed |= pread(fileno(file), pages.data() + slot * PAGE_EDGES, bytes, first * sizeof(uint32_t)) != (ssize_t) bytes;
+        stats.bytesRead += bytes;
+        return (int32_t) slot;
+    }
+};
+
+#endif //HW2_EXTERNAL_SCC_H
@@ -0,0 +1,65 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include "../../../common/generator.h"
+
+/**
+ * Digraph with planted strongly connected components, scale 1 is the size of pub09 (70000 vertices, 200000 edges).
+ * Vertices are laid out in a hidden order split into consecutive components, each component of at least two
+ * vertices is closed by a cycle through its vertices and all the other edges go forward in the hidden order,
+ * so the components are exactly the planted ones. Edges are written in random order and vertex numbers
+ * are a random permutation of the hidden order, only the component boundaries are kept in memory.
+ * usage: generator [scale] [seed] [mean component size = 3] [fraction of vertices in one giant component = 0]
+ */
+int main(int argc, char *argv[]) {
+    GeneratorArguments arguments(argc, argv);
+    double mean_component = argc > 3 ? std::max(1.0, std::atof(argv[3])) : 3;
+    double giant_fraction = argc > 4 ? std::min(1.0, std::max(0.0, std::atof(argv[4]))) : 0;
+    Random random(arguments.seed);
+
+    uint64_t vertices = std::max<uint64_t>(4, (uint64_t) std::llround(70000 * arguments.scale));
+    uint64_t edges = std::max<uint64_t>(vertices, (uint64_t) std::llround(200000 * arguments.scale));
+
+    // component_start[c] is the first hidden position of component c
+    std::vector<uint64_t> component_start{0};
+    uint64_t giant = (uint64_t) (giant_fraction * vertices);
+    if (giant > 0) {
+        component_start.push_back(giant);
+    }
+    uint64_t max_component = std::max<uint64_t>(1, (uint64_t) std::llround(2 * mean_component - 1));
+    while (component_start.back() < vertices) {
+        component_start.push_back(component_start.back() + 1 + random.below(max_component));
+    }
+    component_start.back() = vertices;
+
+    Output out;
+    out << vertices << ' ' << edges << '\n';
+
+    RandomPermutation label(vertices, random), edge_order(edges, random);
+    uint64_t edge_seed = random.next();
+    for (uint64_t i = 0; i < edges; ++i) {
+        uint64_t edge = edge_order(i);
+        uint64_t from, to;
+        // edge number p < vertices is the cycle edge leaving hidden position p when its component has one
+        size_t component = edge < vertices
+                ? std::upper_bound(component_start.begin(), component_start.end(), edge) - component_start.begin() - 1
+                : 0;
+        if (edge < vertices && component_start[component + 1] - component_start[component] > 1) {
+            from = edge;
+            to = edge + 1 < component_start[component + 1] ? edge + 1 : component_start[component];
+        } else {
+            Random edge_random(split_mix(edge_seed ^ edge));
+            from = edge_random.below(vertices);
+            do {
+                to = edge_random.below(vertices);
+            } while (to == from);
+            if (from > to) {
+                std::swap(from, to);
+            }
+        }
+        out << label(from) << ' ' << label(to) << '\n';
+    }
+    return 0;
+}
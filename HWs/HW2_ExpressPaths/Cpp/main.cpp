@@ -3,7 +3,16 @@
 #include <vector>
 #include <list>
 #include <tuple>
-#include <stack>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include "../../../common/graph.h"
+#include "../../../common/instrumentation.h"
+#include "../../../common/batch.h"
+#include "../../../common/binary_input.h"
+#include "scc.h"
+#include "express_queries.h"
+#include "express_path.h"
 
 using std::tuple;
 using std::pair;
@@ -11,176 +20,170 @@ using std::vector;
 using std::list;
 using std::cin;
 using std::cout;
-using std::stack;
 
-class Graph {
-public:
-    uint64_t vertices;
-    std::vector<std::list<uint32_t>> adjacency_list;
+struct Options {
+    std::string queryFile;
+    uint64_t memoryCap = 0; // bytes for edges, 0 keeps the graph in memory
+};
 
-    explicit Graph(uint64_t vertices) : vertices(vertices) {
-        adjacency_list.resize(vertices);
+/**
+ * Answers the queries of the file, one per line, "start v", "end v" or "through v" with 0-based vertex v,
+ * by a line "cost length" of the maximum cost longest express path starting at, ending at or passing through v.
+ */
+int answer_queries(const ExpressPathQueries &queries, const std::string &path, std::ostream &output) {
+    std::ifstream input(path);
+    if (!input) {
+        std::cerr << "hw2: cannot open " << path << std::endl;
+        return 1;
     }
-
-    Graph(Graph &&other) = default;
-
-    void add_edge(uint32_t from, uint32_t to) {
-        adjacency_list[from].emplace_back(to);
+    std::string kind;
+    uint32_t vertex;
+    while (input >> kind >> vertex) {
+        if (vertex >= queries.vertex_count() || (kind != "start" && kind != "end" && kind != "through")) {
+            std::cerr << "hw2: invalid query " << kind << " " << vertex << std::endl;
+            return 1;
+        }
+        const ExpressPath &best = kind == "start" ? queries.starting_at(vertex)
+                                                  : kind == "end" ? queries.ending_at(vertex) : queries.through(vertex);
+        output << best.cost << ' ' << best.length << '\n';
     }
-};
+    output.flush();
+    return 0;
+}
 
-void tarjan_recursive(uint32_t vertex,
-                      uint32_t &time,
-                      Graph &graph,
-                      vector<int32_t> &discovered,
-                      vector<int32_t> &lowest,
-                      vector<bool> &in_stack,
-                      uint32_t &component_number,
-                      vector<int32_t> &component,
-                      vector<uint32_t> &component_sizes,
-                      stack<uint32_t> &stack,
-                      list<uint32_t> &topological_ordering) {
-    discovered[vertex] = time;
-    lowest[vertex] = time;
-    time++;
+int solve(uint32_t vertices, const InputEdge<uint32_t> *first, const InputEdge<uint32_t> *last, const Options &options,
+          std::ostream &output) {
+    PROFILE_START(phase, "build graph");
+    Graph graph = build_directed(vertices, first, last);
 
-    stack.push(vertex);
-    in_stack[vertex] = true;
+    vector<int32_t> component;
+    vector<uint32_t> componentSizes;
+    list<uint32_t> topological_ordering;
 
-    for (uint32_t neighbor : graph.adjacency_list[vertex]) {
-        if (discovered[neighbor] == -1) {
-            tarjan_recursive(neighbor, time, graph, discovered, lowest, in_stack, component_number, component,
-                             component_sizes, stack, topological_ordering);
+    PROFILE_NEXT(phase, "tarjan");
+    std::tie(component, componentSizes, topological_ordering) = tarjan_scc_topo(graph);
 
-            lowest[vertex] = std::min(lowest[vertex], lowest[neighbor]);
-        } else if (in_stack[neighbor]) {
-            lowest[vertex] = std::min(discovered[neighbor], lowest[vertex]);
-        }
+    if (!options.queryFile.empty()) {
+        PROFILE_NEXT(phase, "query tables");
+        ExpressPathQueries queries(graph, component, componentSizes, topological_ordering);
+        PROFILE_NEXT(phase, "queries");
+        return answer_queries(queries, options.queryFile, output);
     }
 
-    if (lowest[vertex] == discovered[vertex]) {
-        component_sizes.push_back(0);
+    uint32_t maxPathCost;
+    uint32_t maxPathLength;
 
-        while (stack.top() != vertex) {
-            uint32_t cur = stack.top();
-            component[cur] = component_number;
-            component_sizes[component_number]++;
-            in_stack[cur] = false;
-            stack.pop();
-        }
-        in_stack[vertex] = false;
-        stack.pop();
-        component[vertex] = component_number;
-        component_sizes[component_number]++;
+    PROFILE_NEXT(phase, "express path");
+    std::tie(maxPathCost, maxPathLength) = find_maximum_cost_longest_express_path(graph, component, componentSizes, topological_ordering);
+
+    output << maxPathCost << " " << maxPathLength << std::endl;
+    return 0;
+}
 
-        component_number++;
+int solve_external(uint32_t vertices, EdgeStream &stream, const Options &options, std::ostream &output) {
+    PROFILE_SCOPE("external express path");
+    IoStats stats;
+    pair<uint32_t, uint32_t> path;
+    if (!external_express_path(vertices, stream, options.memoryCap, stats, path)) {
+        std::cerr << "hw2: invalid edge or temporary file error" << std::endl;
+        return 1;
     }
-    topological_ordering.push_front(vertex);
+    output << path.first << " " << path.second << std::endl;
+    return 0;
 }
 
 /**
- * Find strongly connected components, their sizes and topological ordering of the vertices
- * @param graph
- * @return tuple of (vector of length vertices with elements being the SCC of the vertex at the given index;
- *                  vector of component sizes for the respective index;
- *                  list of topological ordering of vertices)
+ * With a memory cap the edges are parsed into a temporary file in chunks instead of an edge list.
  */
-tuple<vector<int32_t>, vector<uint32_t>, list<uint32_t>> tarjan_scc_topo(Graph &graph) {
-    vector<int32_t> component(graph.vertices, -1);
-    vector<uint32_t> componentSizes;
-    list<uint32_t> topological_ordering;
-
-    vector<int32_t> discovered(graph.vertices, -1);
-    vector<int32_t> lowest(graph.vertices, -1);
-    vector<bool> in_stack(graph.vertices, false);
-    stack<uint32_t> stack;
-    uint32_t time = 0;
-    uint32_t component_number = 0;
+int solve_external(std::istream &input, const Options &options, std::ostream &output) {
+    uint32_t vertices, edges;
+    IoStats stats;
+    EdgeStream stream(stats);
+    {
+        PROFILE_SCOPE("parse");
+        input >> vertices >> edges;
+        vector<InputEdge<uint32_t>> chunk;
+        chunk.reserve(EdgeStream::CHUNK_EDGES);
+        for (uint32_t i = 0; i < edges; i++) {
+            chunk.emplace_back();
+            input >> chunk.back().from >> chunk.back().edge.to;
+            if ((chunk.size() == EdgeStream::CHUNK_EDGES || i + 1 == edges) && !stream.append(chunk.data(), chunk.size())) {
+                std::cerr << "hw2: cannot write a temporary file" << std::endl;
+                return 1;
+            }
+            if (chunk.size() == EdgeStream::CHUNK_EDGES) {
+                chunk.clear();
+            }
+        }
+    }
+    return solve_external(vertices, stream, options, output);
+}
 
-    for (uint64_t v = 0; v < graph.vertices; v++) {
-        if (discovered[v] == -1) {
-            tarjan_recursive(v, time, graph, discovered, lowest, in_stack, component_number, component, componentSizes,
-                             stack, topological_ordering);
+int solve(std::istream &input, const Options &options, std::ostream &output) {
+    if (options.memoryCap > 0 && options.queryFile.empty()) {
+        return solve_external(input, options, output);
+    }
+    uint32_t vertices, edges;
+    vector<InputEdge<uint32_t>> edge_list;
+    {
+        PROFILE_SCOPE("parse");
+        input >> vertices >> edges;
+        edge_list.resize(edges);
+        for (InputEdge<uint32_t> &edge : edge_list) {
+            input >> edge.from >> edge.edge.to;
         }
     }
-    return std::make_tuple(std::move(component), std::move(componentSizes), std::move(topological_ordering));
+    return solve(vertices, edge_list.data(), edge_list.data() + edge_list.size(), options, output);
 }
 
 /**
- * Find longest maximum cost express path.
- * @param graph
- * @return pair of (cost of the path, length of the path)
+ * Binary input when data starts with the binary magic, text otherwise, binary edges are used in place.
  */
-pair<uint32_t, uint32_t> find_maximum_cost_longest_express_path(Graph &graph,
-                                                                vector<int32_t> &component,
-                                                                vector<uint32_t> &component_sizes,
-                                                                list<uint32_t> &topological_order) {
-    uint32_t maxPathCost = 0;
-    uint32_t maxPathLength = 0;
-
-    vector<uint32_t> pathCostTo(graph.vertices);
-    vector<uint32_t> pathLenTo(graph.vertices, 0);
-    vector<bool> visited(graph.vertices, false); //maybe unnecessary
-    for (uint64_t v = 0; v < graph.vertices; v++) {
-        pathCostTo[v] = component_sizes[component[v]];
+int solve(const char *data, size_t size, const Options &options, std::ostream &output) {
+    if (!is_binary_input(data, size)) {
+        BufferInput input(data, size);
+        return solve(input, options, output);
     }
-
-    for (uint32_t vertex : topological_order) {
-        visited[vertex] = true;
-        if (pathLenTo[vertex] > 0 && pathCostTo[vertex] >= maxPathCost) {
-            if (pathCostTo[vertex] == maxPathCost && pathLenTo[vertex] > maxPathLength) {
-                maxPathLength = pathLenTo[vertex];
-            } else {
-                maxPathCost = pathCostTo[vertex];
-                maxPathLength = pathLenTo[vertex];
-            }
-        }
-
-        for (uint32_t neighbor : graph.adjacency_list[vertex]) {
-            if (!visited[neighbor]
-                && component[vertex] != component[neighbor]
-                && component_sizes[component[neighbor]] >= component_sizes[component[vertex]]) {
-                uint32_t costToNeighbor = pathCostTo[vertex] + component_sizes[component[neighbor]];
-                uint32_t lenToNeighbor = pathLenTo[vertex] + 1;
-                if (costToNeighbor > pathCostTo[neighbor]) {
-                    pathCostTo[neighbor] = costToNeighbor;
-                    pathLenTo[neighbor] = lenToNeighbor;
-                } else if (costToNeighbor == pathCostTo[neighbor] && lenToNeighbor > pathLenTo[neighbor]) {
-                    pathLenTo[neighbor] = lenToNeighbor;
-                }
-            }
-        }
+    BinaryInput binary;
+    if (!binary.open(data, size, BinaryTask::HW2)) {
+        std::cerr << "hw2: invalid binary input" << std::endl;
+        return 1;
     }
-
-
-    return std::make_pair(maxPathCost, maxPathLength);
+    if (options.memoryCap > 0 && options.queryFile.empty()) {
+        IoStats stats;
+        EdgeStream stream(stats);
+        stream.assign(binary.edges(0), binary.count(1));
+        return solve_external(binary.count(0), stream, options, output);
+    }
+    return solve(binary.count(0), binary.edges(0), binary.edges(0) + binary.count(1), options, output);
 }
 
-int main() {
+/**
+ * usage: hw2 [--queries file] [--memory-cap MiB] < input, or hw2 [options] --batch [--jobs N] [input...], see batch.h
+ * Input is text or binary, see binary_input.h.
+ * --queries answers the queries of the file instead of printing the best path of the graph, see answer_queries
+ * --memory-cap keeps the edges in temporary files and at most the cap of them in memory, see express_path.h,
+ * binary input is then read in place, queries keep the graph in memory
+ */
+int main(int argc, char *argv[]) {
     std::ios_base::sync_with_stdio(false);
-
-    uint32_t vertices, edges;
-    cin >> vertices >> edges;
-    Graph graph(vertices);
-
-    for (uint32_t e = 0; e < edges; e++) {
-        uint32_t from, to;
-        cin >> from >> to;
-        graph.add_edge(from, to);
+    Options options;
+    BatchOptions batch = parse_batch_options(argc, argv);
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--queries") {
+            options.queryFile = argv[++i];
+        } else if (std::string(argv[i]) == "--memory-cap") {
+            options.memoryCap = std::strtoull(argv[++i], nullptr, 10) << 20;
+        }
     }
-
-    vector<int32_t> component;
-    vector<uint32_t> componentSizes;
-    list<uint32_t> topological_ordering;
-
-    std::tie(component, componentSizes, topological_ordering) = tarjan_scc_topo(graph);
-
-    uint32_t maxPathCost;
-    uint32_t maxPathLength;
-
-    std::tie(maxPathCost, maxPathLength) = find_maximum_cost_longest_express_path(graph, component, componentSizes, topological_ordering);
-
-    cout << maxPathCost << " " << maxPathLength << std::endl;
-
-    return 0;
-}
\ No newline at end of file
+    if (batch.enabled) {
+        return run_batch(batch, [&options](vector<char> &buffer, std::ostream &output) {
+            solve(buffer.data(), buffer.size(), options, output);
+        });
+    }
+    InputFile file;
+    if (load_binary_stdin(file)) {
+        return solve(file.data(), file.size(), options, cout);
+    }
+    return solve(cin, options, cout);
+}
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <list>
+#include <tuple>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "scc.h"
+#include "express_queries.h"
+
+/**
+ * Throughput of ExpressPathQueries against finding the best path from scratch for every query.
+ * Builds the tables for the input graph, checks a sample of vertices against a search from the vertex alone,
+ * then answers a batch of random start, end and through queries.
+ * usage: query_benchmark [millions of queries = 10] [seed] < input
+ */
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * Best express path starting at the source, or ending at it when backward, by the dynamic programming
+ * of the HW2 solution restricted to the vertices reachable from the source.
+ */
+ExpressPath best_from(const Graph &graph, const std::vector<int32_t> &component,
+                      const std::vector<uint32_t> &component_sizes, const std::vector<uint32_t> &order,
+                      const std::vector<uint32_t> &position, uint32_t source, bool backward) {
+    std::vector<ExpressPath> best(graph.vertex_count(), ExpressPath{0, 0});
+    std::vector<bool> reached(graph.vertex_count(), false);
+    best[source] = {component_sizes[component[source]], 0};
+    reached[source] = true;
+    ExpressPath result = best[source];
+    if (!backward) {
+        for (uint32_t i = position[source]; i < order.size(); ++i) {
+            uint32_t vertex = order[i];
+            if (!reached[vertex]) {
+                continue;
+            }
+            if (best[vertex].better_than(result)) {
+                result = best[vertex];
+            }
+            for (const Graph::Edge &edge : graph.neighbors(vertex)) {
+                if (ExpressPathQueries::express_edge(vertex, edge.to, component, component_sizes)) {
+                    ExpressPath path{best[vertex].cost + component_sizes[component[edge.to]], best[vertex].length + 1};
+                    if (!reached[edge.to] || path.better_than(best[edge.to])) {
+                        best[edge.to] = path;
+                        reached[edge.to] = true;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+    // ending at the source, every vertex before it in the order is tried as the start
+    std::vector<ExpressPath> to_source(graph.vertex_count(), ExpressPath{0, 0});
+    std::vector<bool> reaches(graph.vertex_count(), false);
+    to_source[source] = best[source];
+    reaches[source] = true;
+    for (uint32_t i = position[source] + 1; i-- > 0;) {
+        uint32_t vertex = order[i];
+        for (const Graph::Edge &edge : graph.neighbors(vertex)) {
+            if (reaches[edge.to] && ExpressPathQueries::express_edge(vertex, edge.to, component, component_sizes)) {
+                ExpressPath path{to_source[edge.to].cost + component_sizes[component[vertex]], to_source[edge.to].length + 1};
+                if (!reaches[vertex] || path.better_than(to_source[vertex])) {
+                    to_source[vertex] = path;
+                    reaches[vertex] = true;
+                }
+            }
+        }
+        if (reaches[vertex] && to_source[vertex].better_than(result)) {
+            result = to_source[vertex];
+        }
+    }
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t count = (uint64_t) (1000000 * (argc > 1 ? std::atof(argv[1]) : 10));
+    uint32_t seed = argc > 2 ? (uint32_t) std::strtoul(argv[2], nullptr, 10) : 42;
+    std::ios_base::sync_with_stdio(false);
+    uint32_t vertices, edges;
+    std::cin >> vertices >> edges;
+    std::vector<InputEdge<uint32_t>> edge_list(edges);
+    for (InputEdge<uint32_t> &edge : edge_list) {
+        std::cin >> edge.from >> edge.edge.to;
+    }
+    Graph graph = build_directed(vertices, edge_list.data(), edge_list.data() + edge_list.size());
+    std::vector<int32_t> component;
+    std::vector<uint32_t> component_sizes;
+    std::list<uint32_t> topological_order;
+    std::tie(component, component_sizes, topological_order) = tarjan_scc_topo(graph);
+
+    auto start = Clock::now();
+    ExpressPathQueries queries(graph, component, component_sizes, topological_order);
+    double tables_ms = milliseconds(start);
+
+    std::vector<uint32_t> order(topological_order.begin(), topological_order.end()), position(vertices);
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = i;
+    }
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<uint32_t> any_vertex(0, vertices - 1);
+    std::vector<double> search_times;
+    for (int sample = 0; sample < 20; ++sample) {
+        uint32_t vertex = any_vertex(generator);
+        start = Clock::now();
+        ExpressPath starting = best_from(graph, component, component_sizes, order, position, vertex, false);
+        search_times.push_back(milliseconds(start));
+        ExpressPath ending = best_from(graph, component, component_sizes, order, position, vertex, true);
+        const ExpressPath &through = queries.through(vertex);
+        if (starting.cost != queries.starting_at(vertex).cost || starting.length != queries.starting_at(vertex).length
+                || ending.cost != queries.ending_at(vertex).cost || ending.length != queries.ending_at(vertex).length
+                || through.cost != starting.cost + ending.cost - component_sizes[component[vertex]]
+                || through.length != starting.length + ending.length) {
+            std::cerr << "vertex " << vertex << ": tables disagree with the search" << std::endl;
+            return 1;
+        }
+    }
+    std::sort(search_times.begin(), search_times.end());
+
+    std::vector<uint32_t> batch(count);
+    for (uint32_t &query : batch) {
+        query = any_vertex(generator) << 2 | (uint32_t) (generator() % 3);
+    }
+    uint64_t checksum = 0;
+    start = Clock::now();
+    for (uint32_t query : batch) {
+        uint32_t vertex = query >> 2;
+        const ExpressPath &best = (query & 3) == 0 ? queries.starting_at(vertex)
+                                  : (query & 3) == 1 ? queries.ending_at(vertex) : queries.through(vertex);
+        checksum += best.cost + best.length;
+    }
+    double batch_ms = milliseconds(start);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "graph " << vertices << " vertices, " << edges << " edges, " << component_sizes.size()
+              << " components" << std::endl;
+    std::cout << "tables ms            " << tables_ms << std::endl;
+    std::cout << "search per query ms  " << search_times[search_times.size() / 2] << std::endl;
+    std::cout << "queries              " << count << std::endl;
+    std::cout << "batch ms             " << batch_ms << std::endl;
+    std::cout << "ns per query         " << batch_ms * 1e6 / std::max<uint64_t>(1, count) << std::endl;
+    std::cout << "queries per second   " << std::setprecision(0) << count / (batch_ms / 1000) << std::endl;
+    std::cout << "checksum             " << checksum << std::endl;
+    return 0;
+}
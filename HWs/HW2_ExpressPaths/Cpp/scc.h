@@ -0,0 +1,100 @@
+#ifndef HW2_SCC_H
+#define HW2_SCC_H
+
+#include <cstdint>
+#include <vector>
+#include <list>
+#include <tuple>
+#include <stack>
+#include "../../../common/graph.h"
+
+using Graph = CsrGraph<uint32_t>;
+
+/**
+ * Tarjan's algorithm as callbacks of the iterative depth first search
+ */
+struct TarjanVisitor : DepthFirstVisitor {
+    uint32_t time = 0;
+    uint32_t component_number = 0;
+    std::vector<int32_t> &discovered;
+    std::vector<int32_t> &lowest;
+    std::vector<bool> &in_stack;
+    std::vector<int32_t> &component;
+    std::vector<uint32_t> &component_sizes;
+    std::stack<uint32_t> &stack;
+    std::list<uint32_t> &topological_ordering;
+
+    TarjanVisitor(std::vector<int32_t> &discovered, std::vector<int32_t> &lowest, std::vector<bool> &in_stack,
+                  std::vector<int32_t> &component, std::vector<uint32_t> &component_sizes,
+                  std::stack<uint32_t> &stack, std::list<uint32_t> &topological_ordering)
+            : discovered(discovered), lowest(lowest), in_stack(in_stack), component(component),
+              component_sizes(component_sizes), stack(stack), topological_ordering(topological_ordering) {}
+
+    void discover(uint32_t vertex) {
+        discovered[vertex] = time;
+        lowest[vertex] = time;
+        time++;
+
+        stack.push(vertex);
+        in_stack[vertex] = true;
+    }
+
+    void finish_edge(uint32_t vertex, uint32_t neighbor) {
+        lowest[vertex] = std::min(lowest[vertex], lowest[neighbor]);
+    }
+
+    void non_tree_edge(uint32_t vertex, uint32_t neighbor) {
+        if (in_stack[neighbor]) {
+            lowest[vertex] = std::min(discovered[neighbor], lowest[vertex]);
+        }
+    }
+
+    void finish(uint32_t vertex) {
+        if (lowest[vertex] == discovered[vertex]) {
+            component_sizes.push_back(0);
+
+            while (stack.top() != vertex) {
+                uint32_t cur = stack.top();
+                component[cur] = component_number;
+                component_sizes[component_number]++;
+                in_stack[cur] = false;
+                stack.pop();
+            }
+            in_stack[vertex] = false;
+            stack.pop();
+            component[vertex] = component_number;
+            component_sizes[component_number]++;
+
+            component_number++;
+        }
+        topological_ordering.push_front(vertex);
+    }
+};
+
+/**
+ * Find strongly connected components, their sizes and topological ordering of the vertices
+ * @param graph - CsrGraph, or DiskGraph of external_scc.h
+ * @return tuple of (vector of length vertices with elements being the SCC of the vertex at the given index;
+ *                  vector of component sizes for the respective index;
+ *                  list of topological ordering of vertices)
+ */
+template <typename G>
+std::tuple<std::vector<int32_t>, std::vector<uint32_t>, std::list<uint32_t>> tarjan_scc_topo(const G &graph) {
+    std::vector<int32_t> component(graph.vertex_count(), -1);
+    std::vector<uint32_t> componentSizes;
+    std::list<uint32_t> topological_ordering;
+
+    std::vector<int32_t> discovered(graph.vertex_count(), -1);
+    std::vector<int32_t> lowest(graph.vertex_count(), -1);
+    std::vector<bool> in_stack(graph.vertex_count(), false);
+    std::stack<uint32_t> stack;
+
+    TarjanVisitor visitor(discovered, lowest, in_stack, component, componentSizes, stack, topological_ordering);
+    DepthFirstSearch<G> search(graph);
+    for (uint32_t v = 0; v < graph.vertex_count(); v++) {
+        search.run(v, visitor);
+    }
+    return std::make_tuple(std::move(component), std::move(componentSizes), std::move(topological_ordering));
+}
+
+#endif //HW2_SCC_H
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include "certificate.h"
+#include "canonical_form.h"
+
+/**
+ * Time of the canonical form from the center of the tree of cycles against the certificate from the root vertex,
+ * both for every graph of a text input without the invariant prefilter. The graphs and their cycles are built
+ * once beforehand, only the certificates are timed.
+ * usage: canonical_benchmark < input
+ */
+
+using Clock = std::chrono::steady_clock;
+
+struct CycleGraph {
+    Graph graph;
+    uint32_t root;
+    std::vector<int32_t> cycleMembership;
+    std::vector<uint32_t> cycleSizes;
+};
+
+double milliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <typename Key>
+std::vector<uint32_t> class_sizes(const std::unordered_map<Key, uint32_t> &counts) {
+    std::vector<uint32_t> sizes;
+    for (const auto &count : counts) {
+        sizes.push_back(count.second);
+    }
+    std::sort(sizes.begin(), sizes.end());
+    return sizes;
+}
+
+int main() {
+    std::ios_base::sync_with_stdio(false);
+    uint32_t graphs, vertices, edges;
+    std::cin >> graphs >> vertices >> edges;
+    std::vector<InputEdge<uint32_t>> edge_list((size_t) edges);
+    std::vector<CycleGraph> cycle_graphs(graphs);
+    for (CycleGraph &graph : cycle_graphs) {
+        for (InputEdge<uint32_t> &edge : edge_list) {
+            std::cin >> edge.from >> edge.edge.to;
+            edge.from--;
+            edge.edge.to--;
+        }
+        graph.graph = build_undirected(vertices, edge_list.data(), edge_list.data() + edges);
+        std::tie(graph.root, graph.cycleMembership, graph.cycleSizes) = find_cycles(graph.graph);
+    }
+
+    auto start = Clock::now();
+    std::unordered_map<std::string, uint32_t> rooted;
+    for (const CycleGraph &graph : cycle_graphs) {
+        rooted[create_graph_certificate(graph.graph, graph.root, graph.cycleMembership, graph.cycleSizes)]++;
+    }
+    double rooted_ms = milliseconds(start);
+
+    start = Clock::now();
+    CanonicalForms forms;
+    std::unordered_map<uint32_t, uint32_t> centered;
+    for (const CycleGraph &graph : cycle_graphs) {
+        centered[forms.certificate(graph.graph, graph.cycleMembership, graph.cycleSizes)]++;
+    }
+    double centered_ms = milliseconds(start);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << graphs << " graphs of " << vertices << " vertices, " << rooted.size() << " classes" << std::endl;
+    std::cout << std::left << std::setw(16) << "certificate" << std::right << std::setw(10) << "ms" << std::endl;
+    std::cout << std::left << std::setw(16) << "rooted" << std::right << std::setw(10) << rooted_ms << std::endl;
+    std::cout << std::left << std::setw(16) << "centered" << std::right << std::setw(10) << centered_ms << std::endl;
+    std::cout << "speedup " << std::setprecision(2) << rooted_ms / centered_ms << std::endl;
+    if (class_sizes(rooted) != class_sizes(centered)) {
+        std::cerr << "centered classes differ" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,239 @@
+#ifndef HW3_CANONICAL_FORM_H
+#define HW3_CANONICAL_FORM_H
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "certificate.h"
+
+/**
+ * Canonical forms of graphs whose cycles share no vertex, independent of any root.
+ *
+ * Contracting every cycle to a single unit turns the graph into a tree of units, cycles and the vertices on no
+ * cycle, joined by bridges. Peeling its leaves layer by layer finds its center, one unit or two joined by a bridge,
+ * which does not depend on the numbering. A unit is peeled once all units but one around it are, so the peeling
+ * visits the tree bottom up towards the center and encodes every unit as it goes, in the same pass:
+ *  - a vertex is the sorted forms of the units peeled around it,
+ *  - a cycle is the sequence of the sorted forms hanging on its vertices, walked from the vertex of its bridge
+ *    towards the center in the direction that gives the smaller sequence, or from its least rotation in either
+ *    direction when it is the center,
+ *  - two centers are the sorted pair of their forms, each encoded as if below the other.
+ * Every form is interned as an integer id, so a form is its tag and a few ids and comparing graphs is comparing
+ * ids. Ids are shared by all the graphs given to one CanonicalForms.
+ */
+class CanonicalForms {
+public:
+    /**
+     * @return id of the canonical form, equal for two graphs given to this object exactly when they are isomorphic
+     */
+    uint32_t certificate(const Graph &graph, const std::vector<int32_t> &cycleMembership,
+                         const std::vector<uint32_t> &cycleSizes) {
+        uint32_t vertices = graph.vertex_count();
+        uint32_t cycles = (uint32_t) cycleSizes.size();
+        uint32_t units = cycles + vertices;
+        unitOf.resize(vertices);
+        degree.assign(units, 0);
+        cycleStart.assign(cycles + 1, 0);
+        uint32_t remaining = cycles;
+        layer.clear();
+        for (uint32_t v = 0; v < vertices; v++) {
+            bool onCycle = cycleMembership[v] >= 0;
+            unitOf[v] = onCycle ? (uint32_t) cycleMembership[v] : cycles + v;
+            // the bridges of a unit are the edges of its vertices but for the two along a cycle
+            degree[unitOf[v]] += (uint32_t) graph.degree(v) - (onCycle ? 2 : 0);
+            if (onCycle) {
+                cycleStart[unitOf[v] + 1]++;
+            } else {
+                remaining++;
+                if (degree[unitOf[v]] <= 1) {
+                    layer.push_back(unitOf[v]);
+                }
+            }
+        }
+        for (uint32_t c = 0; c < cycles; c++) {
+            if (degree[c] <= 1) {
+                layer.push_back(c);
+            }
+        }
+        orderCycles(graph, cycles);
+        removed.assign(units, false);
+        label.resize(units);
+        while (remaining > 2) {
+            next.clear();
+            for (uint32_t unit : layer) {
+                label[unit] = unitForm(graph, cycles, unit);
+                removed[unit] = true;
+                remaining--;
+            }
+            layer.swap(next);
+        }
+
+        // the units left are the centers, two of them are encoded each below the other
+        for (uint32_t unit : layer) {
+            label[unit] = unitForm(graph, cycles, unit);
+        }
+        if (layer.size() == 1) {
+            return label[layer[0]];
+        }
+        form.assign({CENTERS, std::min(label[layer[0]], label[layer[1]]), std::max(label[layer[0]], label[layer[1]])});
+        return intern();
+    }
+
+    /**
+     * @return index of the least rotation of the sequence
+     */
+    static size_t least_rotation(const std::vector<uint32_t> &sequence) {
+        size_t n = sequence.size(), i = 0, j = 1, k = 0;
+        while (i < n && j < n && k < n) {
+            uint32_t a = sequence[(i + k) % n], b = sequence[(j + k) % n];
+            if (a == b) {
+                k++;
+                continue;
+            }
+            if (a > b) {
+                i += k + 1;
+            } else {
+                j += k + 1;
+            }
+            if (i == j) {
+                j++;
+            }
+            k = 0;
+        }
+        return std::min(i, j);
+    }
+
+private:
+    enum Tag : uint32_t {VERTEX, HANGING, CYCLE, CENTER_CYCLE, CENTERS};
+
+    struct FormHash {
+        size_t operator()(const std::vector<uint32_t> &form) const {
+            uint64_t hash = 0x9e3779b97f4a7c15ULL;
+            for (uint32_t value : form) {
+                hash = (hash ^ value) * 0xff51afd7ed558ccdULL;
+                hash ^= hash >> 32;
+            }
+            return (size_t) hash;
+        }
+    };
+
+    enum : uint32_t {NONE = UINT32_MAX};
+
+    std::unordered_map<std::vector<uint32_t>, uint32_t, FormHash> ids;
+    uint32_t bare[CENTERS + 1] = {NONE, NONE, NONE, NONE, NONE};
+    // scratch of the graph being encoded, kept for the next one
+    std::vector<uint32_t> unitOf, cycleStart, cycleVertices, degree, label, layer, next, form, forward, backward;
+    std::vector<bool> removed;
+
+    uint32_t intern() {
+        // a bare tag, a leaf or a cycle vertex with nothing hanging, is the most common form
+        if (form.size() == 1 && bare[form[0]] != NONE) {
+            return bare[form[0]];
+        }
+        auto found = ids.find(form);
+        if (found != ids.end()) {
+            return found->second;
+        }
+        uint32_t id = (uint32_t) ids.size();
+        ids.emplace(form, id);
+        if (form.size() == 1) {
+            bare[form[0]] = id;
+        }
+        return id;
+    }
+
+    /**
+     * Vertices of every cycle in cyclic order, cycle c is cycleVertices[cycleStart[c], cycleStart[c + 1]),
+     * cycleStart comes with the size of cycle c at c + 1.
+     */
+    void orderCycles(const Graph &graph, uint32_t cycles) {
+        for (uint32_t c = 0; c < cycles; c++) {
+            cycleStart[c + 1] += cycleStart[c];
+        }
+        cycleVertices.resize(cycleStart[cycles]);
+        std::vector<bool> &placed = removed;
+        placed.assign(graph.vertex_count(), false);
+        for (uint32_t v = 0; v < graph.vertex_count(); v++) {
+            if (unitOf[v] < cycles && !placed[v]) {
+                uint32_t position = cycleStart[unitOf[v]];
+                for (uint32_t current = v; current != NONE;) {
+                    placed[current] = true;
+                    cycleVertices[position++] = current;
+                    uint32_t following = NONE;
+                    for (const Graph::Edge &edge : graph.neighbors(current)) {
+                        if (unitOf[edge.to] == unitOf[v] && !placed[edge.to]) {
+                            following = edge.to;
+                            break;
+                        }
+                    }
+                    current = following;
+                }
+            }
+        }
+    }
+
+    /**
+     * Form of the peeled units hanging on the vertex. The unit not peeled yet, if any, is the parent, it loses
+     * a neighbor and joins the next layer once it has one left.
+     * @return true when the vertex has the bridge to the parent
+     */
+    bool hangingForm(const Graph &graph, uint32_t vertex, Tag tag) {
+        uint32_t unit = unitOf[vertex];
+        bool parent = false;
+        form.assign(1, tag);
+        for (const Graph::Edge &edge : graph.neighbors(vertex)) {
+            uint32_t neighbor = unitOf[edge.to];
+            if (neighbor == unit) {
+                continue;
+            }
+            if (removed[neighbor]) {
+                form.push_back(label[neighbor]);
+            } else {
+                parent = true;
+                if (--degree[neighbor] == 1) {
+                    next.push_back(neighbor);
+                }
+            }
+        }
+        std::sort(form.begin() + 1, form.end());
+        return parent;
+    }
+
+    uint32_t unitForm(const Graph &graph, uint32_t cycles, uint32_t unit) {
+        if (unit >= cycles) {
+            hangingForm(graph, unit - cycles, VERTEX);
+            return intern();
+        }
+        uint32_t first = cycleStart[unit], length = cycleStart[unit + 1] - first;
+        forward.resize(length);
+        uint32_t entry = NONE;
+        for (uint32_t i = 0; i < length; i++) {
+            if (hangingForm(graph, cycleVertices[first + i], HANGING)) {
+                entry = i;
+            }
+            forward[i] = intern();
+        }
+        backward.resize(length);
+        for (uint32_t i = 0; i < length; i++) {
+            backward[i] = forward[(length - i) % length];
+        }
+        if (entry != NONE) {
+            // both walks start at the vertex of the bridge to the parent
+            std::rotate(forward.begin(), forward.begin() + entry, forward.end());
+            std::rotate(backward.begin(), backward.begin() + (length - entry) % length, backward.end());
+            form.assign(1, CYCLE);
+        } else {
+            std::rotate(forward.begin(), forward.begin() + least_rotation(forward), forward.end());
+            std::rotate(backward.begin(), backward.begin() + least_rotation(backward), backward.end());
+            form.assign(1, CENTER_CYCLE);
+        }
+        const std::vector<uint32_t> &smaller = std::lexicographical_compare(backward.begin(), backward.end(),
+                                                                           forward.begin(), forward.end())
+                                               ? backward : forward;
+        form.insert(form.end(), smaller.begin(), smaller.end());
+        return intern();
+    }
+};
+
+#endif //HW3_CANONICAL_FORM_H
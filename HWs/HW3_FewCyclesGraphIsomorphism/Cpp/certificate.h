@@ -0,0 +1,269 @@
+#ifndef HW3_CERTIFICATE_H
+#define HW3_CERTIFICATE_H
+
+#include <cstdint>
+#include <vector>
+#include <tuple>
+#include <list>
+#include <string>
+#include <queue>
+#include <unordered_map>
+#include <algorithm>
+#include "../../../common/graph.h"
+#include "../../../common/instrumentation.h"
+
+using Graph = CsrGraph<uint32_t>;
+
+enum class Color {UNSEEN, SEEN, COMPLETED};
+
+/**
+ * Marks the cycles on back edges of the iterative depth first search, every cycle of the graph closes
+ * exactly one back edge. Edges back to the parent are the tree edges seen from the other side.
+ */
+struct CycleVisitor : DepthFirstVisitor {
+    int32_t cycleNumber = 0;
+    std::vector<int32_t> &cycleMembership;
+    std::vector<uint32_t> &cycleSizes;
+    std::vector<Color> &state;
+    std::vector<int32_t> &parent;
+    std::vector<uint32_t> &thirdDegreeVertices;
+    const Graph &graph;
+
+    CycleVisitor(std::vector<int32_t> &cycleMembership, std::vector<uint32_t> &cycleSizes, std::vector<Color> &state,
+                 std::vector<int32_t> &parent, std::vector<uint32_t> &thirdDegreeVertices, const Graph &graph)
+            : cycleMembership(cycleMembership), cycleSizes(cycleSizes), state(state), parent(parent),
+              thirdDegreeVertices(thirdDegreeVertices), graph(graph) {}
+
+    void discover(uint32_t cur) {
+        if (graph.degree(cur) == 3) {
+            thirdDegreeVertices.push_back(cur);
+        }
+        state[cur] = Color::SEEN;
+    }
+
+    void tree_edge(uint32_t cur, uint32_t neigh) {
+        parent[neigh] = cur;
+    }
+
+    void non_tree_edge(uint32_t cur, uint32_t neigh) {
+        if (state[neigh] != Color::SEEN || (uint32_t) parent[cur] == neigh) {
+            return;
+        }
+        cycleSizes.push_back(1);
+        uint32_t cycleCur = cur;
+        cycleMembership[cycleCur] = cycleNumber;
+        while (cycleCur != neigh) {
+            cycleCur = parent[cycleCur];
+            cycleMembership[cycleCur] = cycleNumber;
+            cycleSizes[cycleNumber]++;
+        }
+        cycleNumber++;
+    }
+
+    void finish(uint32_t cur) {
+        state[cur] = Color::COMPLETED;
+    }
+};
+
+/**
+ *
+ * @param graph
+ * @return tuple of root vertex, vector of cycle membership
+ */
+inline std::tuple<uint32_t, std::vector<int32_t>, std::vector<uint32_t>> find_cycles(const Graph &graph) {
+    uint32_t root = 0;
+    std::vector<int32_t> cycleMembership(graph.vertex_count(), -1);
+    std::vector<uint32_t> cycleSizes;
+    std::vector<Color> state(graph.vertex_count(), Color::UNSEEN);
+    std::vector<int32_t> parent(graph.vertex_count(), -1);
+    std::vector<uint32_t> thirdDegreeVertices;
+
+    CycleVisitor visitor(cycleMembership, cycleSizes, state, parent, thirdDegreeVertices, graph);
+    DepthFirstSearch<Graph> search(graph);
+    search.run(0, visitor);
+
+    for (uint32_t vertex : thirdDegreeVertices) {
+        if (cycleMembership[vertex] == -1) {
+            root = vertex;
+            break;
+        }
+    }
+    return std::make_tuple(root, std::move(cycleMembership), std::move(cycleSizes));
+}
+
+/**
+ * Creates certificates for cycles using BFS traversal. Passes all public tests and 9/10 private tests
+ * @param vertex
+ * @param graph
+ * @param cycleMembership
+ * @param cycleSizes
+ * @param visited
+ * @return
+ */
+inline std::string get_child_certificate_cycle_bfs(uint32_t vertex, const Graph &graph, const std::vector<int32_t> &cycleMembership, const std::vector<uint32_t> &cycleSizes, std::vector<bool> &visited) {
+    visited[vertex] = true;
+    if (graph.degree(vertex) == 1) {
+        return "";
+    } else {
+        std::vector<std::list<std::string>> cycleSubcertificates;
+        std::queue<std::pair<uint32_t, uint32_t>> queue;
+        queue.emplace(vertex, 0);
+        while (!queue.empty()) {
+            uint32_t cur;
+            uint32_t depth;
+            std::tie(cur, depth) = queue.front();
+            queue.pop();
+            if (depth+1 > cycleSubcertificates.size()) {
+                cycleSubcertificates.emplace_back();
+            }
+            for (const Graph::Edge &edge : graph.neighbors(cur)) {
+                uint32_t neigh = edge.to;
+                if (!visited[neigh]) {
+                    if (cycleMembership[neigh] != cycleMembership[cur]) {
+                        std::string c = get_child_certificate_cycle_bfs(neigh, graph, cycleMembership, cycleSizes, visited);
+                        if (!c.empty()) {
+                            cycleSubcertificates[depth].push_back(c);
+                        }
+                    } else {
+                        queue.emplace(neigh, depth+1);
+                        visited[neigh] = true;
+                    }
+                }
+            }
+        }
+
+        std::string certificate = std::to_string(cycleSizes[cycleMembership[vertex]]) + "(";
+        for (int i = 0; i < cycleSubcertificates.size(); i++) {
+            if (!cycleSubcertificates[i].empty()) {
+                certificate += std::to_string(i) + ":{";
+                cycleSubcertificates[i].sort();
+                for (auto &subcert : cycleSubcertificates[i]) {
+                    if (!subcert.empty()) {
+                        certificate += subcert;
+                        certificate += ',';
+                    }
+                }
+                certificate += '}';
+            }
+        }
+        certificate += ')';
+        return certificate;
+
+    }
+}
+
+
+/**
+ * creates cycle certificates by walking the cycle in both directions and selecting the lexicographically smaller resulting certificate.
+ * Uses cache for speedup
+ * @param vertex
+ * @param graph
+ * @param cycleMembership
+ * @param cycleSizes
+ * @param visited
+ * @param cache
+ * @return
+ */
+inline std::string get_child_certificate_double_cycle_walk(uint32_t vertex, const Graph &graph, const std::vector<int32_t> &cycleMembership, const std::vector<uint32_t> &cycleSizes, std::vector<bool> &visited, std::unordered_map<uint32_t, std::string> &cache) {
+    visited[vertex] = true;
+    if (graph.degree(vertex) == 1) {
+        return "";
+    } else if (cache.find(vertex) != cache.end()) {
+        return cache[vertex];
+    } else {
+        std::vector<std::list<std::string>> cycleSubcertificates;
+        std::vector<uint32_t> cycleNeighs;
+        for (const Graph::Edge &edge : graph.neighbors(vertex)) {
+            uint32_t n = edge.to;
+            if (cycleMembership[n] == cycleMembership[vertex]) {
+                cycleNeighs.push_back(n);
+            }
+        }
+        std::string smallestCertificate;
+        for (uint32_t dir: cycleNeighs) {
+            std::vector<bool> cycleVisited(graph.vertex_count(), false);
+            cycleVisited[vertex] = true;
+            std::queue<std::pair<uint32_t, uint32_t>> queue;
+            queue.emplace(dir, 0);
+            std::string curCert;
+            while (!queue.empty()) {
+                uint32_t cur;
+                uint32_t depth;
+                std::tie(cur, depth) = queue.front();
+                queue.pop();
+                cycleVisited[cur] = true;
+                for (const Graph::Edge &edge : graph.neighbors(cur)) {
+                    uint32_t neigh = edge.to;
+                    if (!cycleVisited[neigh]) {
+                        if (cycleMembership[neigh] != cycleMembership[cur]) {
+                            std::string c = get_child_certificate_double_cycle_walk(neigh, graph, cycleMembership,
+                                                                               cycleSizes, visited, cache);
+                            if (!c.empty()) {
+                                curCert += 'b';
+                                curCert += c;
+                                curCert += 'b';
+                            } else {
+                                curCert += 'a';
+                            }
+                        } else {
+                            queue.emplace(neigh, depth+1);
+                            visited[neigh] = true;
+                        }
+                    }
+                }
+            }
+            if (dir == cycleNeighs.front() || curCert < smallestCertificate) {
+                smallestCertificate.swap(curCert);
+            }
+        }
+
+        std::string &certificate = cache[vertex];
+        certificate = std::to_string(cycleSizes[cycleMembership[vertex]]) + "(" + smallestCertificate + ")";
+        return certificate;
+
+    }
+}
+
+/**
+ * wrapper for using double cycle walk
+ * @param vertex
+ * @param graph
+ * @param cycleMembership
+ * @param cycleSizes
+ * @param visited
+ * @return
+ */
+inline std::string get_child_certificate2_cached(uint32_t vertex, const Graph &graph, const std::vector<int32_t> &cycleMembership, const std::vector<uint32_t> &cycleSizes, std::vector<bool> &visited) {
+    std::unordered_map<uint32_t, std::string> cache;
+    return get_child_certificate_double_cycle_walk(vertex, graph, cycleMembership, cycleSizes, visited, cache);
+}
+
+inline std::string create_graph_certificate(const Graph &graph, uint32_t root, const std::vector<int32_t> &cycleMembership, const std::vector<uint32_t> &cycleSizes) {
+    std::list<std::string> childCertificates;
+    std::vector<bool> visited(graph.vertex_count(), false);
+    visited[root] = true;
+    for (const Graph::Edge &edge : graph.neighbors(root)) {
+        uint32_t neigh = edge.to;
+        childCertificates.push_back(get_child_certificate2_cached(neigh, graph, cycleMembership, cycleSizes, visited));
+    }
+    childCertificates.sort();
+    std::string certificate;
+    for (auto &str : childCertificates) {
+        certificate += str;
+    }
+    return certificate;
+}
+
+inline std::string graph_certificate(uint32_t vertices, const InputEdge<uint32_t> *first, const InputEdge<uint32_t> *last) {
+    PROFILE_START(phase, "build graph");
+    Graph curGraph = build_undirected(vertices, first, last);
+    std::vector<int32_t> cycleMembership;
+    std::vector<uint32_t> cycleSizes;
+    uint32_t root;
+    PROFILE_NEXT(phase, "find cycles");
+    std::tie(root, cycleMembership, cycleSizes) = find_cycles(curGraph);
+    PROFILE_NEXT(phase, "certificate");
+    return create_graph_certificate(curGraph, root, cycleMembership, cycleSizes);
+}
+
+#endif //HW3_CERTIFICATE_H
@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "../../../common/generator.h"
+
+/**
+ * Builds a graph of the assignment from its hidden structure. The center has three slots, a cycle of length L
+ * takes one open slot with its first vertex and opens a slot at each of its other L - 1 vertices, the remaining
+ * slots end with leaves. With c cycles of total length S there are 4 + 2S - 2c vertices.
+ * @param vertices even, at least 4 + 4 * cycles
+ * @param cycles at least 1
+ * @param random decides the shape, the same seed gives the same graph
+ * @return edges over vertices 0..vertices-1
+ */
+std::vector<std::pair<uint32_t, uint32_t>> build_template(uint32_t vertices, uint32_t cycles, Random &random) {
+    std::vector<uint32_t> lengths(cycles, 3);
+    uint32_t total_length = (vertices - 4) / 2 + cycles;
+    for (uint32_t extra = 3 * cycles; extra < total_length; ++extra) {
+        lengths[random.below(cycles)]++;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<uint32_t> slots{0, 0, 0};
+    uint32_t next_vertex = 1;
+    for (uint32_t length : lengths) {
+        size_t slot = random.below(slots.size());
+        uint32_t parent = slots[slot];
+        slots[slot] = slots.back();
+        slots.pop_back();
+
+        uint32_t first = next_vertex;
+        edges.emplace_back(parent, first);
+        for (uint32_t i = 0; i < length; ++i) {
+            edges.emplace_back(first + i, first + (i + 1) % length);
+            if (i > 0) {
+                slots.push_back(first + i);
+            }
+        }
+        next_vertex += length;
+    }
+    for (uint32_t parent : slots) {
+        edges.emplace_back(parent, next_vertex++);
+    }
+    return edges;
+}
+
+/**
+ * Batch of graphs drawn from planted isomorphism classes, scale 1 is the size of pub10 (60 graphs of 6550 vertices
+ * and 84 cycles). Every class is a random template, every graph is a template of a random class
+ * with randomly renumbered vertices and shuffled edges. Templates are rebuilt from their seeds for every graph,
+ * so only one graph is in memory at a time.
+ * usage: generator [scale] [seed] [classes = graphs / 3] [vertices = 6550] [cycles = 84]
+ */
+int main(int argc, char *argv[]) {
+    GeneratorArguments arguments(argc, argv);
+    Random random(arguments.seed);
+
+    uint64_t graphs = std::max<uint64_t>(1, (uint64_t) std::llround(60 * arguments.scale));
+    uint64_t classes = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::max<uint64_t>(1, graphs / 3);
+    uint32_t vertices = argc > 4 ? (uint32_t) std::strtoul(argv[4], nullptr, 10) : 6550;
+    uint32_t cycles = argc > 5 ? (uint32_t) std::strtoul(argv[5], nullptr, 10) : 84;
+    classes = std::max<uint64_t>(1, std::min(classes, graphs));
+    vertices = std::max<uint32_t>(8, vertices + vertices % 2);
+    cycles = std::max<uint32_t>(1, std::min(cycles, (vertices - 4) / 4));
+    uint32_t edge_count = vertices - 1 + cycles;
+
+    Output out;
+    out << graphs << ' ' << vertices << ' ' << edge_count << '\n';
+
+    uint64_t class_seed = random.next();
+    std::vector<uint32_t> label(vertices);
+    for (uint64_t graph = 0; graph < graphs; ++graph) {
+        // the first graphs go through all the classes so that none of them is empty
+        uint64_t graph_class = graph < classes ? graph : random.below(classes);
+        Random template_random(split_mix(class_seed ^ graph_class));
+        std::vector<std::pair<uint32_t, uint32_t>> edges = build_template(vertices, cycles, template_random);
+
+        for (uint32_t vertex = 0; vertex < vertices; ++vertex) {
+            label[vertex] = vertex + 1;
+        }
+        for (uint32_t i = vertices - 1; i > 0; --i) {
+            std::swap(label[i], label[random.below(i + 1)]);
+        }
+        for (size_t i = edges.size() - 1; i > 0; --i) {
+            std::swap(edges[i], edges[random.below(i + 1)]);
+        }
+        for (const auto &edge : edges) {
+            if (random.chance(0.5)) {
+                out << label[edge.first] << ' ' << label[edge.second] << '\n';
+            } else {
+                out << label[edge.second] << ' ' << label[edge.first] << '\n';
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+#ifndef HW3_PREFILTER_H
+#define HW3_PREFILTER_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <tuple>
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <algorithm>
+#include "certificate.h"
+#include "canonical_form.h"
+
+/**
+ * Isomorphism classes of a batch of graphs in two stages. Every graph first gets a key of invariants computed
+ * in O(V): the vertex count, the degree histogram and the sizes of the cycles, each with the number of leaves
+ * hanging on it, sorted. Isomorphic graphs have equal keys, so a graph alone with its key is a class of its own
+ * and only graphs sharing their key with another one get the canonical form of canonical_form.h.
+ * The graph and cycles found for the key are reused by the canonical form, the first graph of a key is kept
+ * built until a second one comes or the batch ends.
+ */
+class IsomorphismClassifier {
+public:
+    // graphs that needed the full certificate
+    uint32_t certificates = 0;
+
+    void add(uint32_t vertices, const InputEdge<uint32_t> *first, const InputEdge<uint32_t> *last) {
+        PROFILE_START(phase, "build graph");
+        CycleGraph graph;
+        graph.graph = build_undirected(vertices, first, last);
+        PROFILE_NEXT(phase, "find cycles");
+        std::tie(std::ignore, graph.cycleMembership, graph.cycleSizes) = find_cycles(graph.graph);
+        PROFILE_NEXT(phase, "invariants");
+        Bucket &bucket = buckets[invariant_key(graph.graph, graph.cycleMembership, graph.cycleSizes)];
+        PROFILE_NEXT(phase, "certificate");
+        if (bucket.graphs == 0) {
+            bucket.first = std::move(graph);
+        } else {
+            if (bucket.graphs == 1) {
+                bucket.counts[bucket.first.certificate(forms)]++;
+                bucket.first = CycleGraph();
+                certificates++;
+            }
+            bucket.counts[graph.certificate(forms)]++;
+            certificates++;
+        }
+        bucket.graphs++;
+    }
+
+    /**
+     * @return sizes of the isomorphism classes in ascending order
+     */
+    std::vector<uint32_t> class_sizes() const {
+        std::vector<uint32_t> sizes;
+        for (const auto &bucket : buckets) {
+            if (bucket.second.graphs == 1) {
+                sizes.push_back(1);
+            }
+            for (const auto &count : bucket.second.counts) {
+                sizes.push_back(count.second);
+            }
+        }
+        std::sort(sizes.begin(), sizes.end());
+        return sizes;
+    }
+
+private:
+    struct CycleGraph {
+        Graph graph;
+        std::vector<int32_t> cycleMembership;
+        std::vector<uint32_t> cycleSizes;
+
+        uint32_t certificate(CanonicalForms &forms) const {
+            return forms.certificate(graph, cycleMembership, cycleSizes);
+        }
+    };
+
+    struct Bucket {
+        uint32_t graphs = 0;
+        CycleGraph first; // kept until a second graph comes
+        std::unordered_map<uint32_t, uint32_t> counts; // by canonical form, once there are two graphs
+    };
+
+    std::unordered_map<std::string, Bucket> buckets;
+    CanonicalForms forms;
+
+    static std::string invariant_key(const Graph &graph, const std::vector<int32_t> &cycleMembership,
+                                     const std::vector<uint32_t> &cycleSizes) {
+        uint32_t vertices = graph.vertex_count();
+        std::vector<uint32_t> histogram;
+        std::vector<uint32_t> leaves(cycleSizes.size(), 0);
+        for (uint32_t v = 0; v < vertices; v++) {
+            uint64_t degree = graph.degree(v);
+            if (degree >= histogram.size()) {
+                histogram.resize(degree + 1, 0);
+            }
+            histogram[degree]++;
+            if (degree == 1 && cycleMembership[graph.neighbors(v).begin()->to] >= 0) {
+                leaves[cycleMembership[graph.neighbors(v).begin()->to]]++;
+            }
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> cycles;
+        for (size_t c = 0; c < cycleSizes.size(); c++) {
+            cycles.emplace_back(cycleSizes[c], leaves[c]);
+        }
+        std::sort(cycles.begin(), cycles.end());
+
+        std::vector<uint32_t> key{vertices, (uint32_t) histogram.size()};
+        key.insert(key.end(), histogram.begin(), histogram.end());
+        for (const auto &cycle : cycles) {
+            key.push_back(cycle.first);
+            key.push_back(cycle.second);
+        }
+        std::string bytes(key.size() * sizeof(uint32_t), '\0');
+        std::memcpy(&bytes[0], key.data(), bytes.size());
+        return bytes;
+    }
+};
+
+#endif //HW3_PREFILTER_H
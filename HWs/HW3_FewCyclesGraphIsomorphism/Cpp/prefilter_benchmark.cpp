@@ -0,0 +1,70 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include "certificate.h"
+#include "prefilter.h"
+
+/**
+ * Time of the staged IsomorphismClassifier against a full certificate for every graph, on a text input.
+ * usage: prefilter_benchmark < input
+ */
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main() {
+    std::ios_base::sync_with_stdio(false);
+    uint32_t graphs, vertices, edges;
+    std::cin >> graphs >> vertices >> edges;
+    std::vector<InputEdge<uint32_t>> edge_list((size_t) graphs * edges);
+    for (InputEdge<uint32_t> &edge : edge_list) {
+        std::cin >> edge.from >> edge.edge.to;
+        edge.from--;
+        edge.edge.to--;
+    }
+
+    auto start = Clock::now();
+    std::unordered_map<std::string, uint32_t> counts;
+    for (uint32_t graph = 0; graph < graphs; graph++) {
+        const InputEdge<uint32_t> *first = edge_list.data() + (size_t) graph * edges;
+        counts[graph_certificate(vertices, first, first + edges)]++;
+    }
+    std::vector<uint32_t> expected;
+    for (const auto &count : counts) {
+        expected.push_back(count.second);
+    }
+    std::sort(expected.begin(), expected.end());
+    double full_ms = milliseconds(start);
+
+    start = Clock::now();
+    IsomorphismClassifier classifier;
+    for (uint32_t graph = 0; graph < graphs; graph++) {
+        const InputEdge<uint32_t> *first = edge_list.data() + (size_t) graph * edges;
+        classifier.add(vertices, first, first + edges);
+    }
+    std::vector<uint32_t> sizes = classifier.class_sizes();
+    double staged_ms = milliseconds(start);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << graphs << " graphs of " << vertices << " vertices, " << expected.size() << " classes" << std::endl;
+    std::cout << std::left << std::setw(16) << "mode" << std::right << std::setw(10) << "ms" << std::setw(16)
+              << "certificates" << std::endl;
+    std::cout << std::left << std::setw(16) << "certificates" << std::right << std::setw(10) << full_ms
+              << std::setw(16) << graphs << std::endl;
+    std::cout << std::left << std::setw(16) << "prefiltered" << std::right << std::setw(10) << staged_ms
+              << std::setw(16) << classifier.certificates << std::endl;
+    std::cout << "speedup " << std::setprecision(2) << full_ms / staged_ms << std::endl;
+    if (sizes != expected) {
+        std::cerr << "prefiltered classes differ" << std::endl;
+        return 1;
+    }
+    return 0;
+}
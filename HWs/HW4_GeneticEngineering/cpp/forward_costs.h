@@ -0,0 +1,257 @@
+#ifndef HW4_FORWARD_COSTS_H
+#define HW4_FORWARD_COSTS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <array>
+
+constexpr int32_t UNREACHABLE = INT32_MAX - 1;
+
+//{cost, used units} of every prefix of the sequence, one more than the sequence for the empty prefix
+using Costs = std::vector<std::pair<uint32_t, uint32_t>>;
+//{cost, nucleotides} of every basic unit
+using BasicUnits = std::vector<std::pair<uint16_t, std::string>>;
+
+//last basic unit of a cheapest plan of a prefix and the start it is placed at
+struct UnitChoice {
+    uint32_t start;
+    uint16_t unit;
+};
+//UnitChoice of every prefix, parallel to Costs, the traceback walks them from the end of the sequence
+using Choices = std::vector<UnitChoice>;
+
+inline int32_t deletions_count_check(int32_t deletions, uint16_t max_deletions) {
+    return deletions <= max_deletions ? deletions : UNREACHABLE;
+}
+
+/**
+ * Fills costs_cur with the deletions needed to match basic_unit to each prefix of the window, which holds the
+ * costs_len - 1 nucleotides from the start. costs_next is scratch, both vectors are reused between calls,
+ * so they stop allocating once they reach the longest unit.
+ */
+inline void
+forward_costs_generic(const std::string &basic_unit, const char *window, const size_t costs_len, const uint16_t max_deletions,
+                      std::vector<int32_t> &costs_cur, std::vector<int32_t> &costs_next) {
+    costs_cur.assign(costs_len, UNREACHABLE);
+    costs_next.assign(costs_len, UNREACHABLE);
+
+    costs_cur[0] = 0;
+
+    for (size_t unit_idx = 0; unit_idx < basic_unit.size(); ++unit_idx) {
+        std::fill(costs_next.begin(), costs_next.end(), UNREACHABLE);
+        costs_next[0] = deletions_count_check(costs_cur[0] + 1, max_deletions);
+
+        size_t max_idx = std::min(costs_len, unit_idx+2);
+
+        for (size_t costs_offset = 1; costs_offset < max_idx; ++costs_offset) {
+
+            if (basic_unit[unit_idx] == window[costs_offset - 1]){
+                if (costs_cur[costs_offset-1] != UNREACHABLE) {
+                    costs_next[costs_offset] = costs_cur[costs_offset-1];
+                } else {
+                    costs_next[costs_offset] = UNREACHABLE;
+                }
+            }
+
+            if (costs_cur[costs_offset] != UNREACHABLE) {
+                costs_next[costs_offset] = std::min(costs_next[costs_offset], deletions_count_check(costs_cur[costs_offset] + 1, max_deletions));
+            }
+        }
+        costs_cur.swap(costs_next);
+    }
+}
+
+/**
+ * Fills costs_cur with the deletions needed to match basic_unit to each prefix of the sequence from sequence_start_idx.
+ */
+inline void
+find_forward_costs(const std::string &sequence, const std::string &basic_unit, const size_t sequence_start_idx, const uint16_t max_deletions,
+                   std::vector<int32_t> &costs_cur, std::vector<int32_t> &costs_next) {
+    size_t costs_len = std::min(basic_unit.size()+1, sequence.size() - sequence_start_idx + 1);
+    forward_costs_generic(basic_unit, sequence.data() + sequence_start_idx, costs_len, max_deletions, costs_cur, costs_next);
+}
+
+//longest unit with a fixed size kernel, the window the kernels read is padded by as many nucleotides
+constexpr size_t MAX_FIXED_UNIT = 64;
+//shorter units run faster on the generic kernel than on the 8 offsets of the smallest fixed size kernel
+constexpr size_t MIN_FIXED_UNIT = 7;
+
+/**
+ * One nucleotide of the unit in forward_costs_fixed, from the costs_cur row to the costs_next row.
+ */
+template <size_t N>
+inline void forward_costs_step(int32_t nucleotide, const std::array<int32_t, N> &window, int32_t limit,
+                               const std::array<int32_t, N + 1> &costs_cur, std::array<int32_t, N + 1> &costs_next) {
+    costs_next[0] = costs_cur[0] + 1 <= limit ? costs_cur[0] + 1 : UNREACHABLE;
+    for (size_t costs_offset = 1; costs_offset <= N; ++costs_offset) {
+        //both loads are unconditional, so the selects need no branches
+        int32_t diagonal = costs_cur[costs_offset - 1], deleted = costs_cur[costs_offset] + 1;
+        int32_t matched = nucleotide == window[costs_offset - 1] ? diagonal : UNREACHABLE;
+        //UNREACHABLE + 1 is over any limit, so unreachable offsets stay unreachable
+        costs_next[costs_offset] = std::min(matched, deleted <= limit ? deleted : UNREACHABLE);
+    }
+}
+
+/**
+ * Fills forward_costs[0, costs_len) as forward_costs_generic does, for units of at most N nucleotides.
+ * Both rows are std::arrays and every step updates all N offsets without bounds or branches, the offsets the unit
+ * can not reach yet stay UNREACHABLE by themselves, so the inner loop unrolls and vectorizes. The steps alternate
+ * between the two rows by name rather than by swapping pointers, so the compiler sees they do not overlap, and
+ * compare nucleotides widened to the width of the costs. The window must hold N nucleotides, past the end of
+ * the sequence ones that match no nucleotide of a unit.
+ */
+template <size_t N>
+void forward_costs_fixed(const std::string &basic_unit, const char *window, size_t costs_len, uint16_t max_deletions,
+                         int32_t *forward_costs) {
+    std::array<int32_t, N> nucleotides;
+    std::copy(window, window + N, nucleotides.begin());
+    std::array<int32_t, N + 1> even, odd;
+    even.fill(UNREACHABLE);
+    even[0] = 0;
+    const int32_t limit = max_deletions;
+
+    size_t unit_idx = 0;
+    for (; unit_idx + 1 < basic_unit.size(); unit_idx += 2) {
+        forward_costs_step<N>(basic_unit[unit_idx], nucleotides, limit, even, odd);
+        forward_costs_step<N>(basic_unit[unit_idx + 1], nucleotides, limit, odd, even);
+    }
+    if (unit_idx < basic_unit.size()) {
+        forward_costs_step<N>(basic_unit[unit_idx], nucleotides, limit, even, odd);
+        std::copy(odd.begin(), odd.begin() + costs_len, forward_costs);
+    } else {
+        std::copy(even.begin(), even.begin() + costs_len, forward_costs);
+    }
+}
+
+/**
+ * forward_costs_generic behind the signature of the fixed size kernels, for the units longer than MAX_FIXED_UNIT.
+ */
+inline void forward_costs_any(const std::string &basic_unit, const char *window, size_t costs_len, uint16_t max_deletions,
+                              int32_t *forward_costs) {
+    //reused by all the units, blocks and instances a thread computes
+    thread_local std::vector<int32_t> costs_cur, costs_next;
+    forward_costs_generic(basic_unit, window, costs_len, max_deletions, costs_cur, costs_next);
+    std::copy(costs_cur.begin(), costs_cur.end(), forward_costs);
+}
+
+using ForwardKernel = void (*)(const std::string &, const char *, size_t, uint16_t, int32_t *);
+
+/**
+ * @return the fixed size kernel of the shortest bucket of 8, 16, 32 or 64 nucleotides the unit fits in,
+ *         forward_costs_any for units shorter than MIN_FIXED_UNIT or longer than MAX_FIXED_UNIT
+ */
+inline ForwardKernel forward_kernel(size_t unit_length) {
+    if (unit_length < MIN_FIXED_UNIT) {
+        return forward_costs_any;
+    }
+    if (unit_length <= 8) {
+        return forward_costs_fixed<8>;
+    }
+    if (unit_length <= 16) {
+        return forward_costs_fixed<16>;
+    }
+    if (unit_length <= 32) {
+        return forward_costs_fixed<32>;
+    }
+    if (unit_length <= MAX_FIXED_UNIT) {
+        return forward_costs_fixed<MAX_FIXED_UNIT>;
+    }
+    return forward_costs_any;
+}
+
+/**
+ * The sequence padded for the kernels and the kernel of every unit, picked once per input.
+ */
+class ForwardKernels {
+public:
+    ForwardKernels(const std::string &sequence, const BasicUnits &basic_units)
+            : basic_units(basic_units), length(sequence.size()) {
+        window.reserve(sequence.size() + MAX_FIXED_UNIT);
+        window.assign(sequence);
+        window.append(MAX_FIXED_UNIT, '\0');
+        for (const std::pair<uint16_t, std::string> &basic_unit_pair : basic_units) {
+            kernels.push_back(forward_kernel(basic_unit_pair.second.size()));
+        }
+    }
+
+    /**
+     * Fills forward_costs with the forward costs of the unit placed at start_idx.
+     * @return their count
+     */
+    size_t operator()(size_t unit, size_t start_idx, uint16_t max_deletions, int32_t *forward_costs) const {
+        const std::string &basic_unit = basic_units[unit].second;
+        size_t costs_len = std::min(basic_unit.size() + 1, length - start_idx + 1);
+        kernels[unit](basic_unit, window.data() + start_idx, costs_len, max_deletions, forward_costs);
+        return costs_len;
+    }
+
+private:
+    const BasicUnits &basic_units;
+    size_t length;
+    std::string window;
+    std::vector<ForwardKernel> kernels;
+};
+
+/**
+ * Relaxes the costs of the prefixes ending after start_idx by one basic unit placed at start_idx,
+ * forward_costs are its first count forward costs from there. costs[start_idx] must be final.
+ * When choices is set, the prefixes the unit improves record it as their choice.
+ */
+inline void extend_costs(Costs &costs, size_t start_idx, uint16_t basic_unit_cost, const int32_t *forward_costs, size_t count,
+                         UnitChoice *choices = nullptr, uint16_t unit = 0) {
+    uint32_t cost_to_here = costs[start_idx].first, prev_used_units = costs[start_idx].second;
+    for (size_t forward_offset = 1; forward_offset < count; forward_offset++) {
+        uint32_t &current_cost = costs[start_idx + forward_offset].first;
+        uint32_t &current_used_units = costs[start_idx + forward_offset].second;
+
+        if (forward_costs[forward_offset] != UNREACHABLE) {
+            uint32_t potential_cost = ((uint32_t) forward_costs[forward_offset]) + (uint32_t) basic_unit_cost + cost_to_here;
+            //a choice is recorded exactly when {cost, used units} decreases, so the first cheapest plan wins a tie
+            if (potential_cost < current_cost || (current_cost == potential_cost && prev_used_units + 1 < current_used_units)) {
+                current_cost = potential_cost;
+                current_used_units = prev_used_units + 1;
+                if (choices) {
+                    choices[start_idx + forward_offset] = {(uint32_t) start_idx, unit};
+                }
+            }
+
+        }
+    }
+}
+
+/**
+ * Costs of all prefixes, one start after another, every start is extended by every unit once its own cost is final.
+ * @param choices - when set, filled with the choice of every prefix, see traceback.h
+ */
+inline void find_costs(const std::string &sequence, const BasicUnits &basic_units, uint16_t max_deletions, Costs &costs,
+                       Choices *choices = nullptr) {
+    costs.assign(sequence.size()+1, {UINT32_MAX, UINT32_MAX});
+    costs[0] = {0, 0};
+    if (choices) {
+        choices->assign(sequence.size()+1, {0, 0});
+    }
+    UnitChoice *choice_data = choices ? choices->data() : nullptr;
+    ForwardKernels kernels(sequence, basic_units);
+    //reused by all the instances a batch worker solves
+    thread_local std::vector<int32_t> forward_costs;
+    for (const std::pair<uint16_t, std::string> &basic_unit_pair : basic_units) {
+        forward_costs.resize(std::max(forward_costs.size(), basic_unit_pair.second.size() + 1));
+    }
+
+    for (size_t start_idx = 0; start_idx < sequence.size(); ++start_idx) {
+        if (costs[start_idx].first == UINT32_MAX) {
+            //Can't start from this index
+            continue;
+        }
+
+        for (size_t unit = 0; unit < basic_units.size(); ++unit) {
+            size_t count = kernels(unit, start_idx, max_deletions, forward_costs.data());
+            extend_costs(costs, start_idx, basic_units[unit].first, forward_costs.data(), count, choice_data, (uint16_t) unit);
+        }
+    }
+}
+
+#endif //HW4_FORWARD_COSTS_H
@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "../../../common/generator.h"
+
+/**
+ * Sequence assembled from random basic units, scale 1 is the size of pub12 (12019 nucleotides, 23 units
+ * of length 30 to 45, at most 20 deletions). The sequence is a concatenation of units with at most Dmax
+ * nucleotides deleted from each, so a solution always exists, and it is written while it is being assembled.
+ * The last unit is kept whole, so the sequence can be a few nucleotides longer than requested.
+ * usage: generator [scale] [seed] [units = 23] [max deletions = 20] [min unit length = 30] [max unit length = 45]
+ */
+int main(int argc, char *argv[]) {
+    GeneratorArguments arguments(argc, argv);
+    Random random(arguments.seed);
+
+    uint64_t length = std::max<uint64_t>(1, (uint64_t) std::llround(12019 * arguments.scale));
+    uint32_t unit_count = argc > 3 ? (uint32_t) std::strtoul(argv[3], nullptr, 10) : 23;
+    uint32_t max_deletions = argc > 4 ? (uint32_t) std::strtoul(argv[4], nullptr, 10) : 20;
+    uint32_t min_unit = argc > 5 ? (uint32_t) std::strtoul(argv[5], nullptr, 10) : 30;
+    uint32_t max_unit = argc > 6 ? (uint32_t) std::strtoul(argv[6], nullptr, 10) : 45;
+    unit_count = std::max<uint32_t>(1, unit_count);
+    max_deletions = std::max<uint32_t>(1, max_deletions);
+    min_unit = std::max<uint32_t>(1, min_unit);
+    max_unit = std::max(min_unit, max_unit);
+
+    const char nucleotides[] = "AGCT";
+    std::vector<std::string> units(unit_count);
+    std::vector<uint32_t> costs(unit_count);
+    for (uint32_t i = 0; i < unit_count; ++i) {
+        units[i].resize((size_t) random.between(min_unit, max_unit));
+        for (char &nucleotide : units[i]) {
+            nucleotide = nucleotides[random.below(4)];
+        }
+        costs[i] = (uint32_t) random.between(1, 500);
+    }
+
+    Output out;
+    std::vector<bool> deleted;
+    for (uint64_t written = 0; written < length;) {
+        const std::string &unit = units[random.below(unit_count)];
+        uint64_t deletions = random.below(std::min<uint64_t>(max_deletions, unit.size() - 1) + 1);
+        deleted.assign(unit.size(), false);
+        for (uint64_t i = 0; i < deletions;) {
+            size_t position = random.below(unit.size());
+            if (!deleted[position]) {
+                deleted[position] = true;
+                ++i;
+            }
+        }
+        for (size_t i = 0; i < unit.size(); ++i) {
+            if (!deleted[i]) {
+                out << unit[i];
+                written++;
+            }
+        }
+    }
+    out << '\n' << unit_count << ' ' << max_deletions << '\n';
+    for (uint32_t i = 0; i < unit_count; ++i) {
+        out << costs[i] << '\n' << units[i] << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include "forward_costs.h"
+
+/**
+ * Time per (start, unit) pair of the kernel forward_kernel picks for a unit length against the generic kernel,
+ * on random units and a random sequence. Both must give the same forward costs.
+ * usage: kernel_benchmark [pairs per length = 200000] [max deletions = 20] [seed = 1]
+ */
+
+using Clock = std::chrono::steady_clock;
+
+std::string random_nucleotides(std::mt19937 &generator, size_t length) {
+    const char nucleotides[] = "AGCT";
+    std::string result(length, 'A');
+    for (char &nucleotide : result) {
+        nucleotide = nucleotides[generator() % 4];
+    }
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    size_t pairs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    uint16_t max_deletions = (uint16_t) (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20);
+    std::mt19937 generator(argc > 3 ? (uint32_t) std::strtoul(argv[3], nullptr, 10) : 1);
+    std::string sequence = random_nucleotides(generator, 1 << 14);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(8) << "length" << std::setw(8) << "kernel" << std::right << std::setw(14)
+              << "generic ns" << std::setw(12) << "fixed ns" << std::setw(10) << "speedup" << std::endl;
+    for (size_t length : {2, 4, 6, 7, 8, 12, 16, 24, 32, 45, 64, 100}) {
+        BasicUnits basic_units{{1, random_nucleotides(generator, length)}};
+        // a unit that matches at many starts, so the rows are not mostly unreachable
+        std::string repeated = basic_units[0].second;
+        for (size_t i = 0; i < sequence.size(); i += 2 * length) {
+            sequence.replace(i, std::min(length, sequence.size() - i), repeated, 0, std::min(length, sequence.size() - i));
+        }
+        ForwardKernels kernels(sequence, basic_units);
+        std::vector<int32_t> costs_cur, costs_next, fixed(length + 1);
+        size_t starts = sequence.size() - length;
+
+        // last forward costs of the timed pairs, which must agree, keep the timed loops from being dropped
+        int64_t generic_sum = 0, fixed_sum = 0;
+        auto start = Clock::now();
+        for (size_t pair = 0; pair < pairs; ++pair) {
+            find_forward_costs(sequence, basic_units[0].second, pair % starts, max_deletions, costs_cur, costs_next);
+            generic_sum += costs_cur.back();
+        }
+        double generic_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / pairs;
+
+        start = Clock::now();
+        for (size_t pair = 0; pair < pairs; ++pair) {
+            kernels(0, pair % starts, max_deletions, fixed.data());
+            fixed_sum += fixed[length];
+        }
+        double fixed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / pairs;
+
+        if (generic_sum != fixed_sum) {
+            std::cerr << "kernels differ for length " << length << std::endl;
+            return 1;
+        }
+        for (size_t start_idx = 0; start_idx < sequence.size(); start_idx += 7) {
+            find_forward_costs(sequence, basic_units[0].second, start_idx, max_deletions, costs_cur, costs_next);
+            size_t count = kernels(0, start_idx, max_deletions, fixed.data());
+            if (count != costs_cur.size() || !std::equal(costs_cur.begin(), costs_cur.end(), fixed.begin())) {
+                std::cerr << "kernels differ for length " << length << " at " << start_idx << std::endl;
+                return 1;
+            }
+        }
+        const char *kernel = forward_kernel(length) == forward_costs_any ? "generic"
+                           : length <= 8 ? "<=8" : length <= 16 ? "<=16" : length <= 32 ? "<=32" : "<=64";
+        std::cout << std::left << std::setw(8) << length << std::setw(8) << kernel << std::right << std::setw(14)
+                  << generic_ns << std::setw(12) << fixed_ns << std::setw(10) << std::setprecision(2)
+                  << generic_ns / fixed_ns << std::setprecision(1) << std::endl;
+    }
+    return 0;
+}
@@ -3,104 +3,93 @@
 #include <tuple>
 #include <vector>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include "forward_costs.h"
+#include "parallel_costs.h"
+#include "traceback.h"
+#include "../../../common/instrumentation.h"
+#include "../../../common/batch.h"
 
 using namespace std;
 
-constexpr int32_t UNREACHABLE = INT32_MAX - 1;
-
-vector<int32_t> find_forward_costs(const string &sequence, const string &basic_unit, size_t sequence_start_idx, uint16_t max_deletions);
-
-int32_t deletions_count_check(int32_t deletions, uint16_t max_deletions) {
-    return deletions <= max_deletions ? deletions : UNREACHABLE;
-}
-
-vector<int32_t>
-find_forward_costs(const string &sequence, const string &basic_unit, const size_t sequence_start_idx, const uint16_t max_deletions) {
-    size_t costs_len = min(basic_unit.size()+1, sequence.size() - sequence_start_idx + 1);
-    vector<int32_t> costs_cur(costs_len, UNREACHABLE);
-    vector<int32_t> costs_next(costs_len, UNREACHABLE);
-
-    costs_cur[0] = 0;
-
-    for (size_t unit_idx = 0; unit_idx < basic_unit.size(); ++unit_idx) {
-        fill(costs_next.begin(), costs_next.end(), UNREACHABLE);
-        costs_next[0] = deletions_count_check(costs_cur[0] + 1, max_deletions);
-
-        size_t max_idx = min(costs_len, unit_idx+2);
-
-        for (size_t costs_offset = 1; costs_offset < max_idx; ++costs_offset) {
-
-            if (basic_unit[unit_idx] == sequence[sequence_start_idx + costs_offset - 1]){
-                if (costs_cur[costs_offset-1] != UNREACHABLE) {
-                    costs_next[costs_offset] = costs_cur[costs_offset-1];
-                } else {
-                    costs_next[costs_offset] = UNREACHABLE;
-                }
-            }
-
-            if (costs_cur[costs_offset] != UNREACHABLE) {
-                costs_next[costs_offset] = min(costs_next[costs_offset], deletions_count_check(costs_cur[costs_offset] + 1, max_deletions));
-            }
-        }
-        costs_cur.swap(costs_next);
-    }
-
-    return costs_cur;
-}
-
-int main() {
+/**
+ * @param threads - forward costs are computed on a pool of this many threads when more than one
+ * @param traceback - the cost line is followed by the plan, a line per used unit: the position of its first
+ *                    nucleotide in the sequence, its index among the basic units, both from 0, and its
+ *                    nucleotides with the deleted ones in lower case
+ * @return 0, or 1 when the plan can not be traced
+ */
+int solve(istream &input, ostream &output, unsigned threads, bool traceback) {
+    PROFILE_START(phase, "parse");
     string sequence{};
-    vector<pair<uint16_t, string>> basic_units;
+    BasicUnits basic_units;
     uint16_t basic_unit_count{}, max_deletions{};
-    cin >> sequence >> basic_unit_count >> max_deletions;
+    input >> sequence >> basic_unit_count >> max_deletions;
     for (uint16_t i = 0; i < basic_unit_count; i++) {
         uint16_t unit_cost{};
         string basic_unit{};
-        cin >> unit_cost >> basic_unit;
+        input >> unit_cost >> basic_unit;
         basic_units.emplace_back(unit_cost, basic_unit);
     }
 
-    //contains additional index compared to sequence, for initial costs
-    vector<pair<uint32_t, uint32_t>> costs(sequence.size()+1, {UINT32_MAX, UINT32_MAX});
-    costs[0] = {0, 0};
-
-    for (size_t start_idx = 0; start_idx < sequence.size(); ++start_idx) {
-        uint32_t cost_to_here, prev_used_units;
-        tie(cost_to_here, prev_used_units) = costs[start_idx];
+    PROFILE_NEXT(phase, "forward costs");
+    Costs costs;
+    Choices choices;
+    Choices *recorded_choices = traceback ? &choices : nullptr;
+    if (threads > 1) {
+        ThreadPool pool(threads);
+        find_costs_parallel(sequence, basic_units, max_deletions, pool, costs, recorded_choices);
+    } else {
+        find_costs(sequence, basic_units, max_deletions, costs, recorded_choices);
+    }
 
-        if (cost_to_here == UINT32_MAX) {
-            //Can't start from this index
-            continue;
+    uint32_t minimal_cost{}, minimal_unit_count{};
+    tie(minimal_cost, minimal_unit_count) = costs.back();
+    output << minimal_cost << " " << minimal_unit_count << endl;
+
+    if (traceback) {
+        PROFILE_NEXT(phase, "traceback");
+        vector<UnitPlacement> plan;
+        if (!trace_units(sequence, basic_units, costs, choices, plan)) {
+            cerr << "hw4: no plan makes the sequence" << endl;
+            return 1;
         }
-
-        for (pair<uint16_t, string> &basic_unit_pair : basic_units) {
-            uint16_t basic_unit_cost = basic_unit_pair.first;
-            string &basic_unit = basic_unit_pair.second;
-            vector<int32_t> forward_costs = find_forward_costs(sequence, basic_unit, start_idx, max_deletions);
-
-            for (size_t forward_offset = 1; forward_offset < forward_costs.size(); forward_offset++) {
-                uint32_t &current_cost = costs[start_idx + forward_offset].first;
-                uint32_t &current_used_units = costs[start_idx + forward_offset].second;
-
-                if (forward_costs[forward_offset] != UNREACHABLE) {
-                    uint32_t potential_cost = ((uint32_t) forward_costs[forward_offset]) + (uint32_t) basic_unit_cost + cost_to_here;
-                    if (current_cost == potential_cost) {
-                        current_used_units = min(current_used_units, prev_used_units + 1);
-                    }
-
-                    if (potential_cost < current_cost) {
-                        current_cost = potential_cost;
-                        current_used_units = prev_used_units + 1;
-                    }
-
-                }
+        for (const UnitPlacement &placement : plan) {
+            string nucleotides = basic_units[placement.unit].second;
+            for (uint16_t deleted : placement.deleted) {
+                nucleotides[deleted] = (char) tolower(nucleotides[deleted]);
             }
-
+            output << placement.start << " " << placement.unit << " " << nucleotides << "\n";
         }
     }
-
-    uint32_t minimal_cost{}, minimal_unit_count{};
-    tie(minimal_cost, minimal_unit_count) = costs.back();
-    cout << minimal_cost << " " << minimal_unit_count << endl;
     return 0;
+}
+
+/**
+ * usage: hw4 [--threads N] [--traceback] < input, or hw4 [--threads N] [--traceback] --batch [--jobs N] [input...],
+ * see batch.h
+ * --threads N computes the forward costs of every instance on N threads, see parallel_costs.h
+ * --traceback prints the plan after the costs, see solve and traceback.h
+ */
+int main(int argc, char *argv[]) {
+    ios_base::sync_with_stdio(false);
+    unsigned threads = 1;
+    bool traceback = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = (unsigned) max(1, atoi(argv[i + 1]));
+        } else if (strcmp(argv[i], "--traceback") == 0) {
+            traceback = true;
+        }
+    }
+    BatchOptions batch = parse_batch_options(argc, argv);
+    if (batch.enabled) {
+        return run_batch(batch, [threads, traceback](vector<char> &buffer, ostream &output) {
+            BufferInput input(buffer);
+            solve(input, output, threads, traceback);
+        });
+    }
+    return solve(cin, cout, threads, traceback);
 }
\ No newline at end of file
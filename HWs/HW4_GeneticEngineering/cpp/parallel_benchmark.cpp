@@ -0,0 +1,78 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include "forward_costs.h"
+#include "parallel_costs.h"
+
+/**
+ * Scaling of find_costs_parallel from 1 to N threads against the sequential find_costs, on one input.
+ * Every run is repeated and the median is reported, the costs of all runs must equal the sequential ones.
+ * usage: parallel_benchmark [max threads = hardware threads] [repetitions = 3] < input
+ * hw4_generator with a large scale and many units makes long inputs, such as hw4_generator 8 1 60
+ */
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Function>
+double median_ms(unsigned repetitions, Function function) {
+    std::vector<double> times;
+    for (unsigned i = 0; i < repetitions; ++i) {
+        auto start = Clock::now();
+        function();
+        times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char *argv[]) {
+    unsigned max_threads = argc > 1 ? (unsigned) std::strtoul(argv[1], nullptr, 10)
+                                    : std::max(1u, std::thread::hardware_concurrency());
+    unsigned repetitions = argc > 2 ? (unsigned) std::max(1ul, std::strtoul(argv[2], nullptr, 10)) : 3;
+    std::ios_base::sync_with_stdio(false);
+    std::string sequence;
+    BasicUnits basic_units;
+    uint16_t basic_unit_count{}, max_deletions{};
+    std::cin >> sequence >> basic_unit_count >> max_deletions;
+    for (uint16_t i = 0; i < basic_unit_count; i++) {
+        uint16_t unit_cost{};
+        std::string basic_unit;
+        std::cin >> unit_cost >> basic_unit;
+        basic_units.emplace_back(unit_cost, basic_unit);
+    }
+
+    Costs expected, costs;
+    double sequential_ms = median_ms(repetitions, [&]() {
+        find_costs(sequence, basic_units, max_deletions, expected);
+    });
+    size_t reachable = std::count_if(expected.begin(), expected.end() - 1, [](const std::pair<uint32_t, uint32_t> &cost) {
+        return cost.first != UINT32_MAX;
+    });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << sequence.size() << " nucleotides, " << basic_units.size() << " units, " << reachable
+              << " reachable starts, cost " << expected.back().first << " " << expected.back().second << std::endl;
+    std::cout << std::left << std::setw(12) << "threads" << std::right << std::setw(12) << "median ms"
+              << std::setw(10) << "speedup" << std::endl;
+    std::cout << std::left << std::setw(12) << "sequential" << std::right << std::setw(12) << sequential_ms
+              << std::setw(10) << std::setprecision(2) << 1.0 << std::setprecision(1) << std::endl;
+    for (unsigned threads = 1; threads <= max_threads; ++threads) {
+        ThreadPool pool(threads);
+        double ms = median_ms(repetitions, [&]() {
+            find_costs_parallel(sequence, basic_units, max_deletions, pool, costs);
+        });
+        std::cout << std::left << std::setw(12) << threads << std::right << std::setw(12) << ms
+                  << std::setw(10) << std::setprecision(2) << sequential_ms / ms << std::setprecision(1) << std::endl;
+        if (costs != expected) {
+            std::cerr << "costs on " << threads << " threads differ" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
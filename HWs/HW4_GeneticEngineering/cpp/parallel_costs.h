@@ -0,0 +1,65 @@
+#ifndef HW4_PARALLEL_COSTS_H
+#define HW4_PARALLEL_COSTS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "forward_costs.h"
+#include "../../../common/thread_pool.h"
+
+/**
+ * Costs of all prefixes in two stages per block of starts. The forward costs of a unit placed at a start do not
+ * depend on the costs, only their fold into the costs does, so the first stage computes the forward costs of
+ * every (start, unit) pair of the block on the pool, a row of the table per pair, and the second stage folds the
+ * rows into the costs one start after another, in the order of the sequential find_costs, so ties resolve the same.
+ *
+ * The first stage is quadratic in the unit length per pair, the fold linear, so the fold is a small sequential
+ * part. Unlike find_costs the first stage can not skip starts that turn out unreachable, their rows are computed
+ * and dropped. Blocks bound the table to block_starts rows of every unit.
+ * The fold records the choices when they are set, the same ones find_costs records.
+ */
+inline void find_costs_parallel(const std::string &sequence, const BasicUnits &basic_units, uint16_t max_deletions,
+                                ThreadPool &pool, Costs &costs, Choices *choices = nullptr, size_t block_starts = 256) {
+    costs.assign(sequence.size()+1, {UINT32_MAX, UINT32_MAX});
+    costs[0] = {0, 0};
+    if (choices) {
+        choices->assign(sequence.size()+1, {0, 0});
+    }
+    UnitChoice *choice_data = choices ? choices->data() : nullptr;
+
+    //row of unit u at a start begins at row_offsets[u], the rows of a start take row_offsets.back() entries
+    std::vector<size_t> row_offsets{0};
+    for (const std::pair<uint16_t, std::string> &basic_unit_pair : basic_units) {
+        row_offsets.push_back(row_offsets.back() + basic_unit_pair.second.size() + 1);
+    }
+    size_t start_stride = row_offsets.back();
+    ForwardKernels kernels(sequence, basic_units);
+    //reused by all the instances a batch worker solves, the pool threads reach it through the reference
+    thread_local std::vector<int32_t> table_storage;
+    std::vector<int32_t> &table = table_storage;
+    table.resize(std::min(block_starts, sequence.size()) * start_stride);
+
+    for (size_t block_start = 0; block_start < sequence.size(); block_start += block_starts) {
+        size_t block_size = std::min(block_starts, sequence.size() - block_start);
+        size_t unit_count = basic_units.size();
+        pool.for_each(block_size * unit_count, [&](size_t pair, unsigned) {
+            size_t start = pair / unit_count, unit = pair % unit_count;
+            kernels(unit, block_start + start, max_deletions, table.data() + start * start_stride + row_offsets[unit]);
+        });
+
+        for (size_t start = 0; start < block_size; ++start) {
+            size_t start_idx = block_start + start;
+            if (costs[start_idx].first == UINT32_MAX) {
+                continue;
+            }
+            for (size_t unit = 0; unit < basic_units.size(); ++unit) {
+                size_t count = std::min(basic_units[unit].second.size() + 1, sequence.size() - start_idx + 1);
+                extend_costs(costs, start_idx, basic_units[unit].first,
+                             table.data() + start * start_stride + row_offsets[unit], count, choice_data, (uint16_t) unit);
+            }
+        }
+    }
+}
+
+#endif //HW4_PARALLEL_COSTS_H
@@ -0,0 +1,74 @@
+#ifndef HW4_TRACEBACK_H
+#define HW4_TRACEBACK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "forward_costs.h"
+
+/**
+ * One basic unit of a manufacturing plan, it makes the nucleotides [start, end) of the sequence.
+ */
+struct UnitPlacement {
+    size_t start;
+    size_t end;
+    uint16_t unit;
+    //offsets in the unit of its deleted nucleotides, ascending
+    std::vector<uint16_t> deleted;
+};
+
+/**
+ * Deletions that turn basic_unit into the segment [start, end) of the sequence, recomputed for a placement
+ * of the plan instead of being kept for every (start, unit, offset) during the forward pass. Nucleotides
+ * of the sequence are never deleted, so an alignment is an embedding of the segment in the unit as a
+ * subsequence, and matching every nucleotide of the segment to the leftmost one left in the unit finds one
+ * whenever one exists, in one pass and no memory beyond the result. Any embedding deletes the same number
+ * of nucleotides, |unit| - |segment|, which is the forward cost the placement was chosen by.
+ * @return false when the segment is not a subsequence of the unit
+ */
+inline bool align_unit(const std::string &sequence, size_t start, size_t end, const std::string &basic_unit,
+                       std::vector<uint16_t> &deleted) {
+    deleted.clear();
+    size_t sequence_idx = start;
+    for (size_t unit_idx = 0; unit_idx < basic_unit.size(); ++unit_idx) {
+        if (sequence_idx < end && basic_unit[unit_idx] == sequence[sequence_idx]) {
+            ++sequence_idx;
+        } else {
+            deleted.push_back((uint16_t) unit_idx);
+        }
+    }
+    return sequence_idx == end;
+}
+
+/**
+ * Plan of the whole sequence, left to right, from the costs and choices find_costs or find_costs_parallel recorded.
+ * Only the last unit of every prefix is kept, the walk follows them back from the end of the sequence
+ * and aligns each placement it visits on demand, so the traceback needs the choices, O(|sequence|), on top
+ * of the costs, plus the plan itself.
+ * @return false, with plan empty, when the sequence can not be made or a chosen unit does not align
+ *         with its segment, which means the choices do not belong to the costs
+ */
+inline bool trace_units(const std::string &sequence, const BasicUnits &basic_units, const Costs &costs,
+                        const Choices &choices, std::vector<UnitPlacement> &plan) {
+    plan.clear();
+    if (costs.back().first == UINT32_MAX) {
+        return false;
+    }
+    for (size_t end = sequence.size(); end > 0; end = plan.back().start) {
+        const UnitChoice &choice = choices[end];
+        if (choice.start >= end || choice.unit >= basic_units.size()) {
+            plan.clear();
+            return false;
+        }
+        plan.push_back({choice.start, end, choice.unit, {}});
+        if (!align_unit(sequence, choice.start, end, basic_units[choice.unit].second, plan.back().deleted)) {
+            plan.clear();
+            return false;
+        }
+    }
+    std::reverse(plan.begin(), plan.end());
+    return true;
+}
+
+#endif //HW4_TRACEBACK_H
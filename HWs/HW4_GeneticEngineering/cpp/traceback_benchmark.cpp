@@ -0,0 +1,137 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "forward_costs.h"
+#include "parallel_costs.h"
+#include "traceback.h"
+
+/**
+ * Overhead of the traceback against the cost only find_costs on one input: find_costs recording the choices
+ * and trace_units on top of it. Every run is repeated and the median is reported. The plan must make the
+ * sequence at its cost with its unit count, deleting at most Dmax nucleotides per unit, and
+ * find_costs_parallel must record the same choices.
+ * usage: traceback_benchmark [repetitions = 5] < input
+ */
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Function>
+double median_ms(unsigned repetitions, Function function) {
+    std::vector<double> times;
+    for (unsigned i = 0; i < repetitions; ++i) {
+        auto start = Clock::now();
+        function();
+        times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/**
+ * @return empty when the plan makes the sequence at the expected cost, what is wrong with it otherwise
+ */
+std::string check_plan(const std::string &sequence, const BasicUnits &basic_units, uint16_t max_deletions,
+                       const std::vector<UnitPlacement> &plan, const std::pair<uint32_t, uint32_t> &expected) {
+    std::string made;
+    uint32_t cost = 0;
+    for (const UnitPlacement &placement : plan) {
+        const std::string &basic_unit = basic_units[placement.unit].second;
+        if (placement.start != made.size() || placement.deleted.size() > max_deletions) {
+            return "placement at " + std::to_string(placement.start) + " is out of place or over the deletions";
+        }
+        std::vector<bool> deleted(basic_unit.size(), false);
+        for (uint16_t offset : placement.deleted) {
+            deleted[offset] = true;
+        }
+        for (size_t unit_idx = 0; unit_idx < basic_unit.size(); ++unit_idx) {
+            if (!deleted[unit_idx]) {
+                made += basic_unit[unit_idx];
+            }
+        }
+        if (made.size() != placement.end) {
+            return "placement at " + std::to_string(placement.start) + " does not end at " + std::to_string(placement.end);
+        }
+        cost += basic_units[placement.unit].first + (uint32_t) placement.deleted.size();
+    }
+    if (made != sequence) {
+        return "plan makes another sequence";
+    }
+    if (cost != expected.first || plan.size() != expected.second) {
+        return "plan costs " + std::to_string(cost) + " " + std::to_string(plan.size());
+    }
+    return "";
+}
+
+int main(int argc, char *argv[]) {
+    unsigned repetitions = argc > 1 ? (unsigned) std::max(1ul, std::strtoul(argv[1], nullptr, 10)) : 5;
+    std::ios_base::sync_with_stdio(false);
+    std::string sequence;
+    BasicUnits basic_units;
+    uint16_t basic_unit_count{}, max_deletions{};
+    std::cin >> sequence >> basic_unit_count >> max_deletions;
+    for (uint16_t i = 0; i < basic_unit_count; i++) {
+        uint16_t unit_cost{};
+        std::string basic_unit;
+        std::cin >> unit_cost >> basic_unit;
+        basic_units.emplace_back(unit_cost, basic_unit);
+    }
+
+    Costs expected, costs;
+    Choices choices, parallel_choices;
+    std::vector<UnitPlacement> plan;
+    double cost_only_ms = median_ms(repetitions, [&]() {
+        find_costs(sequence, basic_units, max_deletions, expected);
+    });
+    double choices_ms = median_ms(repetitions, [&]() {
+        find_costs(sequence, basic_units, max_deletions, costs, &choices);
+    });
+    bool traced = false;
+    double trace_ms = median_ms(repetitions, [&]() {
+        traced = trace_units(sequence, basic_units, costs, choices, plan);
+    });
+
+    if (costs != expected) {
+        std::cerr << "costs recording the choices differ" << std::endl;
+        return 1;
+    }
+    if (!traced) {
+        std::cerr << "no plan makes the sequence" << std::endl;
+        return 1;
+    }
+    std::string error = check_plan(sequence, basic_units, max_deletions, plan, expected.back());
+    if (!error.empty()) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    ThreadPool pool(2);
+    find_costs_parallel(sequence, basic_units, max_deletions, pool, costs, &parallel_choices);
+    for (size_t end = 1; end < choices.size(); ++end) {
+        if (expected[end].first != UINT32_MAX && (choices[end].start != parallel_choices[end].start
+                                                  || choices[end].unit != parallel_choices[end].unit)) {
+            std::cerr << "parallel choice of prefix " << end << " differs" << std::endl;
+            return 1;
+        }
+    }
+
+    size_t deletions = 0;
+    for (const UnitPlacement &placement : plan) {
+        deletions += placement.deleted.size();
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << sequence.size() << " nucleotides, " << basic_units.size() << " units, plan of " << plan.size()
+              << " units with " << deletions << " deletions" << std::endl;
+    std::cout << std::left << std::setw(16) << "cost only" << std::right << std::setw(12) << cost_only_ms << " ms"
+              << std::endl;
+    std::cout << std::left << std::setw(16) << "with choices" << std::right << std::setw(12) << choices_ms << " ms"
+              << std::setw(10) << 100 * (choices_ms / cost_only_ms - 1) << " %" << std::endl;
+    std::cout << std::left << std::setw(16) << "trace units" << std::right << std::setw(12) << trace_ms << " ms"
+              << std::setw(10) << 100 * trace_ms / cost_only_ms << " %" << std::endl;
+    std::cout << std::left << std::setw(16) << "choices memory" << std::right << std::setw(12)
+              << choices.size() * sizeof(UnitChoice) / 1024.0 << " KiB" << std::endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "../../../common/generator.h"
+
+bool is_prime(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint64_t d = 2; d * d <= n; ++d) {
+        if (n % d == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t random_prime(uint64_t low, uint64_t high, Random &random) {
+    uint64_t candidate;
+    do {
+        candidate = (uint64_t) random.between((int64_t) low, (int64_t) high);
+    } while (!is_prime(candidate));
+    return candidate;
+}
+
+uint64_t gcd(uint64_t a, uint64_t b) {
+    while (b != 0) {
+        uint64_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * Step between the multipliers of full period LCGs, the product of the distinct prime factors of m,
+ * doubled when 4 divides m (Hull-Dobell theorem).
+ */
+uint64_t multiplier_step(uint64_t m) {
+    uint64_t step = 1, rest = m;
+    for (uint64_t p = 2; p * p <= rest; ++p) {
+        if (rest % p == 0) {
+            step *= p;
+            while (rest % p == 0) {
+                rest /= p;
+            }
+        }
+    }
+    if (rest > 1) {
+        step *= rest;
+    }
+    return m % 4 == 0 ? 2 * step : step;
+}
+
+/**
+ * Modulus of the chosen factor structure, at most max_m, the structures with a repeated prime factor
+ * always admit a full period LCG with 2 <= A < M.
+ */
+uint64_t random_modulus(const std::string &structure, uint64_t max_m, Random &random) {
+    if (structure == "power-of-two") {
+        uint64_t m = 8;
+        while (m * 2 <= max_m) {
+            m *= 2;
+        }
+        return m;
+    }
+    if (structure == "prime-power") {
+        uint64_t p = random_prime(2, std::max<uint64_t>(2, (uint64_t) std::sqrt((double) max_m)), random);
+        uint64_t m = p * p;
+        while (m <= max_m / p) {
+            m *= p;
+        }
+        return m;
+    }
+    if (structure == "smooth") {
+        const uint64_t small_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+        uint64_t p = small_primes[random.below(4)];
+        uint64_t m = p == 2 ? 8 : p * p;
+        for (int tries = 0; tries < 64; ++tries) {
+            uint64_t q = small_primes[random.below(sizeof(small_primes) / sizeof(small_primes[0]))];
+            if (m <= max_m / q) {
+                m *= q;
+            }
+        }
+        return m;
+    }
+    if (structure == "square-times-prime") {
+        // odd p, 4 q would admit no multiplier below M
+        uint64_t p = random_prime(3, std::max<uint64_t>(3, (uint64_t) std::cbrt((double) max_m)), random);
+        uint64_t q = random_prime(2, std::max<uint64_t>(2, max_m / (p * p)), random);
+        return p * p * q;
+    }
+    // random modulus from the upper half of the range with a repeated prime factor
+    uint64_t m;
+    do {
+        m = (uint64_t) random.between((int64_t) std::max<uint64_t>(4, max_m / 2), (int64_t) std::max<uint64_t>(4, max_m));
+    } while (multiplier_step(m) >= m - 1);
+    return m;
+}
+
+/**
+ * Instances with a modulus of the chosen factor structure, one "M X2 X3" line each, scale 1 is the size
+ * of the public data (M up to 3.2e7). X2 and X3 are two consecutive values of a random full period LCG,
+ * so at least one solution exists. Every instance draws its own modulus, or with a number of moduli
+ * given, picks one of that many moduli drawn up front, so a stream of queries repeats its moduli.
+ * usage: generator [scale] [seed] [random|smooth|prime-power|power-of-two|square-times-prime] [instances = 1]
+ *                  [moduli = instances]
+ */
+int main(int argc, char *argv[]) {
+    GeneratorArguments arguments(argc, argv);
+    Random random(arguments.seed);
+    std::string structure = argc > 3 ? argv[3] : "random";
+    uint64_t instances = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+    uint64_t max_m = std::max<uint64_t>(8, (uint64_t) std::llround(3.2e7 * arguments.scale));
+
+    std::vector<uint64_t> moduli;
+    if (argc > 5) {
+        moduli.resize(std::max<uint64_t>(1, std::strtoull(argv[5], nullptr, 10)));
+        for (uint64_t &m : moduli) {
+            m = random_modulus(structure, max_m, random);
+        }
+    }
+
+    Output out;
+    for (uint64_t instance = 0; instance < instances; ++instance) {
+        uint64_t m = moduli.empty() ? random_modulus(structure, max_m, random) : moduli[random.below(moduli.size())];
+        uint64_t step = multiplier_step(m);
+        uint64_t a = 1 + step * (1 + random.below((m - 2) / step));
+        uint64_t c;
+        do {
+            c = 1 + random.below(m);
+        } while (gcd(c, m) != 1);
+        uint64_t x2 = random.below(m);
+        uint64_t x3 = (uint64_t) (((unsigned __int128) a * x2 + c) % m);
+        out << m << ' ' << x2 << ' ' << x3 << '\n';
+    }
+    return 0;
+}
@@ -3,6 +3,16 @@
 #include <cmath>
 #include <utility>
 #include <tuple>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include "modulus_cache.h"
+#include "../../../common/instrumentation.h"
+#include "../../../common/batch.h"
+#include "../../../common/thread_pool.h"
 
 long long int inverse(long long int a, long long int m);
 
@@ -48,10 +58,37 @@ long long int gcd(long long int a, long long int b) {
     return b;
 }
 
-int main() {
-    ios_base::sync_with_stdio(false);
+/**
+ * Count, minimum and maximum of the X1 that precede x2, x3 in a full period LCG modulo M
+ */
+struct Answer {
+    uint64_t count = 0;
+    long long int x1_min = INT64_MAX;
+    long long int x1_max = -1;
+};
+
+/**
+ * @param candidate - step between the multipliers of full period LCGs, see ModulusFactors
+ */
+Answer find_answer(long long int M, long long int x2, long long int x3, long long int candidate) {
+    Answer answer;
+    for (long long int A = candidate+1; A < M; A+=candidate) {
+        long long int x1 = find_x1(A, M, x2, x3);
+        if (answer.x1_max < x1) {
+            answer.x1_max = x1;
+        }
+        if (answer.x1_min > x1) {
+            answer.x1_min = x1;
+        }
+        answer.count++;
+    }
+    return answer;
+}
+
+void solve(istream &input, ostream &output) {
     long long int M, x2, x3;
-    cin >> M >> x2 >> x3;
+    input >> M >> x2 >> x3;
+    PROFILE_START(phase, "factorize");
     auto factors = prime_factors_set(M);
     long long int candidate = 1;
     for (auto p : factors) {
@@ -62,23 +99,98 @@ int main() {
         candidate *= 2; //if M divisible by 4, candidate already constructed by multiplying 2, so just multiply again
     }
 
-    long long int x1_max = -1;
-    int64_t x1_min = INT64_MAX;
-    uint64_t count = 0;
+    PROFILE_NEXT(phase, "multipliers");
+    Answer answer = find_answer(M, x2, x3, candidate);
 
-    for (long long int A = candidate+1; A < M; A+=candidate) {
-        long long int x1 = find_x1(A, M, x2, x3);
-        if (x1_max < x1) {
-            x1_max = x1;
+    output << answer.count << " " << answer.x1_min << " " << answer.x1_max << endl;
+}
+
+/**
+ * Answers "M X2 X3" queries until the end of input, a line each in input order. The queries are read in blocks,
+ * the sieve is extended to the largest modulus of a block before it is answered on the pool, whose threads
+ * share the sieve and the cache of moduli. Query count, cache hits and queries per second go to stderr.
+ * @param cache_capacity - moduli kept in the least recently used cache, 0 factorizes every query
+ */
+void answer_queries(istream &input, ostream &output, unsigned threads, size_t cache_capacity, size_t block_queries = 1 << 14) {
+    auto start = chrono::steady_clock::now();
+    PrimeSieve sieve;
+    ModulusCache cache(cache_capacity);
+    ThreadPool pool(threads);
+    vector<tuple<long long int, long long int, long long int>> queries;
+    vector<Answer> answers;
+    uint64_t query_count = 0;
+    string line;
+
+    bool more = true;
+    while (more) {
+        queries.clear();
+        long long int M, x2, x3, block_max = 0;
+        while (queries.size() < block_queries && (more = (bool) (input >> M >> x2 >> x3))) {
+            queries.emplace_back(M, x2, x3);
+            block_max = max(block_max, M);
         }
-        if (x1_min > x1) {
-            x1_min = x1;
+        sieve.cover(block_max);
+        answers.resize(queries.size());
+        pool.for_each(queries.size(), [&](size_t query, unsigned) {
+            //reused by all the queries a thread answers
+            thread_local ModulusFactors modulus;
+            long long int M, x2, x3;
+            tie(M, x2, x3) = queries[query];
+            cache.lookup(M, sieve, modulus);
+            answers[query] = find_answer(M, x2, x3, modulus.step);
+        });
+        for (const Answer &answer : answers) {
+            line.clear();
+            line += to_string(answer.count);
+            line += ' ';
+            line += to_string(answer.x1_min);
+            line += ' ';
+            line += to_string(answer.x1_max);
+            line += '\n';
+            output << line;
         }
-        count++;
+        query_count += queries.size();
     }
+    output.flush();
 
-    cout << count << " " << x1_min << " " << x1_max << endl;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "queries: %llu queries, %u threads, %llu cache hits, %llu misses, %.3f s, %.1f queries/s\n",
+            (unsigned long long) query_count, threads, (unsigned long long) cache.hit_count(),
+            (unsigned long long) cache.miss_count(), seconds, seconds > 0 ? query_count / seconds : 0.0);
+}
 
+/**
+ * usage: hw5 < input, or hw5 --batch [--jobs N] [input...], see batch.h,
+ * or hw5 --queries [--threads N] [--cache N] < queries, see answer_queries
+ * --threads N answers the queries on N threads, 1 by default
+ * --cache N keeps the factors of the N most recently used moduli, 65536 by default
+ */
+int main(int argc, char *argv[]) {
+    ios_base::sync_with_stdio(false);
+    bool queries = false;
+    unsigned threads = 1;
+    size_t cache_capacity = 1 << 16;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--queries") == 0) {
+            queries = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = (unsigned) max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cache_capacity = (size_t) strtoull(argv[++i], nullptr, 10);
+        }
+    }
+    if (queries) {
+        answer_queries(cin, cout, threads, cache_capacity);
+        return 0;
+    }
+    BatchOptions batch = parse_batch_options(argc, argv);
+    if (batch.enabled) {
+        return run_batch(batch, [](vector<char> &buffer, ostream &output) {
+            BufferInput input(buffer);
+            solve(input, output);
+        });
+    }
+    solve(cin, cout);
     return 0;
 }
 
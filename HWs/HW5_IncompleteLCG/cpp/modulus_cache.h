@@ -0,0 +1,163 @@
+#ifndef HW5_MODULUS_CACHE_H
+#define HW5_MODULUS_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <cmath>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Primes up to a limit, for trial division of the moduli up to its square. The limit only grows,
+ * extend must not run while another thread factorizes.
+ */
+class PrimeSieve {
+public:
+    /**
+     * Sieves the primes up to limit, when it is above the current one.
+     */
+    void extend(long long int limit) {
+        if (limit <= this->limit) {
+            return;
+        }
+        std::vector<bool> composite((size_t) limit + 1, false);
+        primes.clear();
+        for (long long int i = 2; i <= limit; ++i) {
+            if (composite[i]) {
+                continue;
+            }
+            primes.push_back(i);
+            for (long long int multiple = i * i; multiple <= limit; multiple += i) {
+                composite[multiple] = true;
+            }
+        }
+        this->limit = limit;
+    }
+
+    /**
+     * Extends the sieve so it can factorize every number up to n.
+     */
+    void cover(long long int n) {
+        //the double square root may be off by one either way for large n
+        long long int root = (long long int) std::sqrt((double) n);
+        while (root > 0 && root * root > n) {
+            --root;
+        }
+        while ((root + 1) * (root + 1) <= n) {
+            ++root;
+        }
+        extend(root);
+    }
+
+    /**
+     * Distinct prime factors of n, which must be covered, in increasing order, written into factors.
+     */
+    void prime_factors_set(long long int n, std::vector<long long int> &factors) const {
+        factors.clear();
+        for (long long int p : primes) {
+            if (p * p > n) {
+                break;
+            }
+            if (n % p == 0) {
+                factors.push_back(p);
+                while (n % p == 0) {
+                    n /= p;
+                }
+            }
+        }
+        if (n > 1) {
+            factors.push_back(n);
+        }
+    }
+
+private:
+    long long int limit = 1;
+    std::vector<long long int> primes;
+};
+
+/**
+ * What a query needs of its modulus M: the distinct prime factors and the step between the multipliers A
+ * of full period LCGs modulo M, their product doubled when 4 divides M.
+ */
+struct ModulusFactors {
+    std::vector<long long int> factors;
+    long long int step = 1;
+
+    void compute(long long int M, const PrimeSieve &sieve) {
+        sieve.prime_factors_set(M, factors);
+        step = 1;
+        for (long long int p : factors) {
+            step *= p;
+        }
+        if (M % 4 == 0) {
+            step *= 2;
+        }
+    }
+};
+
+/**
+ * Least recently used ModulusFactors of up to capacity moduli, shared by the threads answering queries.
+ * A miss is factorized by the thread that missed, outside the lock, so two threads missing the same modulus
+ * at once both factorize it and the second insert is dropped. A capacity of 0 caches nothing.
+ */
+class ModulusCache {
+public:
+    explicit ModulusCache(size_t capacity) : capacity(capacity) {}
+
+    /**
+     * Fills entry with the factors of M, from the cache or from the sieve.
+     */
+    void lookup(long long int M, const PrimeSieve &sieve, ModulusFactors &entry) {
+        if (capacity == 0) {
+            entry.compute(M, sieve);
+            misses++;
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = index.find(M);
+            if (found != index.end()) {
+                recent.splice(recent.begin(), recent, found->second);
+                //assigning reuses the capacity of the caller's vector
+                entry.factors = found->second->second.factors;
+                entry.step = found->second->second.step;
+                hits++;
+                return;
+            }
+            misses++;
+        }
+        entry.compute(M, sieve);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index.count(M) > 0) {
+            return;
+        }
+        if (recent.size() == capacity) {
+            index.erase(recent.back().first);
+            recent.pop_back();
+        }
+        recent.emplace_front(M, entry);
+        index.emplace(M, recent.begin());
+    }
+
+    uint64_t hit_count() const {
+        return hits;
+    }
+
+    uint64_t miss_count() const {
+        return misses;
+    }
+
+private:
+    size_t capacity;
+    std::mutex mutex;
+    //most recently used first
+    std::list<std::pair<long long int, ModulusFactors>> recent;
+    std::unordered_map<long long int, std::list<std::pair<long long int, ModulusFactors>>::iterator> index;
+    std::atomic<uint64_t> hits{0}, misses{0};
+};
+
+#endif //HW5_MODULUS_CACHE_H
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include "splay_tree.h"
+
+/**
+ * Compares rotations, pointer updates and time per operation of the splay strategies.
+ * usage: benchmark [keys] [seed]
+ */
+
+enum class OpType {INSERT, ERASE, FIND, LOWER_BOUND};
+
+struct Op {
+    OpType type;
+    uint32_t value;
+};
+
+/**
+ * ascending inserts, descending finds and ascending erases, each access is next to the previous one
+ */
+std::vector<Op> sequential_stream(uint32_t keys) {
+    std::vector<Op> ops;
+    ops.reserve(3 * keys);
+    for (uint32_t key = 1; key <= keys; ++key) {
+        ops.push_back({OpType::INSERT, key});
+    }
+    for (uint32_t key = keys; key >= 1; --key) {
+        ops.push_back({OpType::FIND, key});
+    }
+    for (uint32_t key = 1; key <= keys; ++key) {
+        ops.push_back({OpType::ERASE, key});
+    }
+    return ops;
+}
+
+/**
+ * even keys inserted in random order, then random finds and lower bounds of odd keys, then erases in random order
+ */
+std::vector<Op> random_stream(uint32_t keys, std::mt19937 &generator) {
+    std::vector<uint32_t> values(keys);
+    std::iota(values.begin(), values.end(), 1);
+    std::shuffle(values.begin(), values.end(), generator);
+    std::uniform_int_distribution<uint32_t> any_key(1, keys);
+
+    std::vector<Op> ops;
+    ops.reserve(4 * keys);
+    for (uint32_t value : values) {
+        ops.push_back({OpType::INSERT, 2 * value});
+    }
+    for (uint32_t i = 0; i < keys; ++i) {
+        ops.push_back({OpType::FIND, 2 * any_key(generator)});
+        ops.push_back({OpType::LOWER_BOUND, 2 * any_key(generator) - 1});
+    }
+    std::shuffle(values.begin(), values.end(), generator);
+    for (uint32_t value : values) {
+        ops.push_back({OpType::ERASE, 2 * value});
+    }
+    return ops;
+}
+
+/**
+ * ascending inserts degenerate the zig-only tree into a path, then accessing the keys in ascending order
+ * always hits the deepest key and keeps it a path. Quadratic for zig-only splaying,
+ * so use far fewer keys than the other streams.
+ */
+std::vector<Op> adversarial_stream(uint32_t keys) {
+    std::vector<Op> ops;
+    ops.reserve(3 * keys);
+    for (uint32_t key = 1; key <= keys; ++key) {
+        ops.push_back({OpType::INSERT, key});
+    }
+    for (uint32_t key = 1; key <= keys; ++key) {
+        ops.push_back({OpType::FIND, key});
+    }
+    for (uint32_t key = 1; key <= keys; ++key) {
+        ops.push_back({OpType::ERASE, key});
+    }
+    return ops;
+}
+
+template <typename Strategy>
+void run(const std::string &strategy_name, const std::string &stream_name, const std::vector<Op> &ops) {
+    SplayTree<Strategy> tree;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Op &op : ops) {
+        switch (op.type) {
+            case OpType::INSERT:
+                tree.insert(op.value);
+                break;
+            case OpType::ERASE:
+                checksum += tree.erase(op.value);
+                break;
+            case OpType::FIND:
+                checksum += tree.find(op.value);
+                break;
+            case OpType::LOWER_BOUND: {
+                const Node *bound = tree.lower_bound(op.value);
+                checksum += bound != nullptr ? bound->value : 0;
+                break;
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    const SplayStats &stats = tree.get_stats();
+    double op_count = ops.size();
+
+    std::cout << std::left << std::setw(12) << stream_name << std::setw(10) << strategy_name << std::right
+              << std::setw(10) << ops.size()
+              << std::setw(14) << stats.rotations / op_count
+              << std::setw(14) << stats.pointer_updates / op_count
+              << std::setw(12) << ns / op_count
+              << std::setw(22) << checksum << std::endl;
+}
+
+void run_all(const std::string &stream_name, const std::vector<Op> &ops) {
+    run<FullSplay>("full", stream_name, ops);
+    run<ZigOnlySplay>("zig", stream_name, ops);
+    run<SemiSplay>("semi", stream_name, ops);
+    run<TopDownSplay>("top-down", stream_name, ops);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t keys = argc > 1 ? (uint32_t) std::strtoul(argv[1], nullptr, 10) : 400000;
+    uint32_t seed = argc > 2 ? (uint32_t) std::strtoul(argv[2], nullptr, 10) : 42;
+    std::mt19937 generator(seed);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(12) << "stream" << std::setw(10) << "strategy" << std::right
+              << std::setw(10) << "ops"
+              << std::setw(14) << "rotations/op"
+              << std::setw(14) << "pointers/op"
+              << std::setw(12) << "ns/op"
+              << std::setw(22) << "checksum" << std::endl;
+
+    run_all("sequential", sequential_stream(keys));
+    run_all("random", random_stream(keys, generator));
+    run_all("adversarial", adversarial_stream(std::max<uint32_t>(1, keys / 40)));
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "../../../common/generator.h"
+
+/**
+ * Bijection from insertion numbers to keys 1..blocks * BLOCK. Consecutive insertion numbers form blocks,
+ * a block is mapped to a random key block and walks it ascending, descending or in shuffled order,
+ * which produces the long sorted runs that are expensive for the zig-only tree.
+ */
+class KeySequence {
+public:
+    static constexpr uint64_t BLOCK = 1024;
+
+    KeySequence(uint64_t blocks, Random &random) : block_order(blocks, random), seed(random.next()) {}
+
+    int64_t key(uint64_t insertion) const {
+        uint64_t block = insertion / BLOCK, offset = insertion % BLOCK;
+        uint64_t pattern = split_mix(seed ^ block);
+        switch (pattern % 3) {
+            case 0:
+                break;
+            case 1:
+                offset = BLOCK - 1 - offset;
+                break;
+            default:
+                offset = (offset * ((pattern >> 8) | 1) + (pattern >> 32)) % BLOCK;
+        }
+        return (int64_t) (block_order(block) * BLOCK + offset + 1);
+    }
+
+private:
+    RandomPermutation block_order;
+    uint64_t seed;
+};
+
+/**
+ * Insert and delete stream, scale 1 is the size of pub09 (306479 operations, keys up to 1.2e7).
+ * Live keys are a window [oldest, newest) of insertion numbers, deletes take the oldest key or the newest one,
+ * so every delete hits a key in the tree and every insert a key out of it without remembering the keys.
+ * Phases of random length alternate between growing and shrinking the tree and between the two delete ends.
+ * usage: generator [scale] [seed]
+ */
+int main(int argc, char *argv[]) {
+    GeneratorArguments arguments(argc, argv);
+    Random random(arguments.seed);
+
+    uint64_t operations = std::max<uint64_t>(1, (uint64_t) std::llround(306479 * arguments.scale));
+    uint64_t key_space = std::min<uint64_t>(INT32_MAX - KeySequence::BLOCK,
+                                            std::max<uint64_t>(operations, (uint64_t) std::llround(1.2e7 * arguments.scale)));
+    KeySequence keys((key_space + KeySequence::BLOCK - 1) / KeySequence::BLOCK, random);
+
+    Output out;
+    out << operations << '\n';
+    uint64_t oldest = 0, newest = 0, phase_end = 0;
+    double insert_probability = 1;
+    bool delete_oldest = true;
+    for (uint64_t operation = 0; operation < operations; ++operation) {
+        if (operation == phase_end) {
+            phase_end = operation + 1 + random.below(std::max<uint64_t>(1, operations / 20));
+            insert_probability = random.chance(0.6) ? 0.8 : 0.35;
+            delete_oldest = random.chance(0.5);
+        }
+        if (operation > 0) {
+            out << ' ';
+        }
+        if (oldest == newest || random.chance(insert_probability)) {
+            out << keys.key(newest++);
+        } else if (delete_oldest) {
+            out << -keys.key(oldest++);
+        } else {
+            out << -keys.key(--newest);
+        }
+    }
+    out << '\n';
+    return 0;
+}
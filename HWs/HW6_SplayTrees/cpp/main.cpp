@@ -1,287 +1,179 @@
 #include <iostream>
+#include <iomanip>
+#include <cstdio>
 #include <cstdint>
-#include <algorithm>
-
-struct Node {
-    Node *left = nullptr;
-    Node *right = nullptr;
-    Node *parent = nullptr;
-    const uint32_t value;
-
-    explicit Node(const uint32_t value) : value(value) {}
-
-    ~Node() {
-        delete left;
-        delete right;
-    }
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <future>
+#include <functional>
+#include "splay_tree.h"
+#include "../../../common/instrumentation.h"
+#include "../../../common/batch.h"
+
+struct StrategyResult {
+    TreeShape shape;
+    SplayStats stats;
+    double seconds;
 };
 
 /**
- * return root of the inserted tree
- * @param tree
- * @param insert
- * @return
+ * Parses the operation count followed by the operations, positive is insert, negative is delete.
+ * Whole input is read at once and parsed by hand, it is shared read-only by all the trees afterwards.
+ * @param buffer - whole input, a terminating zero is appended
+ * @return vector of operations
  */
-Node* insert_bst(Node *tree, Node *insert) {
-    if (tree == nullptr) {
-        return insert;
-    } else {
-        Node *current = tree;
-        Node *parent = nullptr;
-        while (current != nullptr) {
-            parent = current;
-            current = insert->value < current->value ? current->left : current->right;
+std::vector<int32_t> parse_operations(std::vector<char> &buffer) {
+    buffer.push_back('\0');
+
+    std::vector<int32_t> operations;
+    const char *cur = buffer.data();
+    auto next_number = [&cur](int64_t &number) {
+        while (*cur != '\0' && *cur != '-' && (*cur < '0' || *cur > '9')) {
+            cur++;
         }
-        if (insert->value < parent->value) {
-            parent->left = insert;
-        } else {
-            parent->right = insert;
+        if (*cur == '\0') {
+            return false;
         }
-        insert->parent = parent;
-        return tree;
-    }
-}
-
-/**
- * return Node* to the node containing the passed in value
- * must exist in the tree
- * @param tree
- * @param value
- * @return
- */
-Node* find_bst(Node *tree, uint32_t value) {
-    Node *current = tree;
-    while (current != nullptr && current->value != value) {
-        current = value < current->value ? current->left : current->right;
-    }
-    return current;
-}
-
-void fix_parent_down_pointer(Node *parent, Node *original, Node *new_child) {
-    if (parent != nullptr) {
-        if (parent->left == original) {
-            parent->left = new_child;
-        } else {
-            parent->right = new_child;
+        bool negative = *cur == '-';
+        if (negative) {
+            cur++;
         }
-    }
-}
+        number = 0;
+        while (*cur >= '0' && *cur <= '9') {
+            number = number * 10 + (*cur - '0');
+            cur++;
+        }
+        if (negative) {
+            number = -number;
+        }
+        return true;
+    };
 
-Node* zig_R(Node* lower) {
-    Node *higher = lower->parent;
-    Node *lower_r = lower->right;
-    lower->parent = higher->parent;
-    lower->right = higher;
-    higher->parent = lower;
-    higher->left = lower_r;
-    if (lower_r != nullptr) {
-        lower_r->parent = higher;
+    int64_t N{}, operation{};
+    if (!next_number(N)) {
+        return operations;
     }
-    fix_parent_down_pointer(lower->parent, higher, lower);
-    return lower;
-}
-
-Node* zig_L(Node* lower) {
-    Node *higher = lower->parent;
-    Node *lower_l = lower->left;
-    lower->parent = higher->parent;
-    lower->left = higher;
-    higher->parent = lower;
-    higher->right = lower_l;
-    if (lower_l != nullptr) {
-        lower_l->parent = higher;
+    operations.reserve(N);
+    for (int64_t i = 0; i < N && next_number(operation); i++) {
+        operations.push_back((int32_t) operation);
     }
-    fix_parent_down_pointer(lower->parent, higher, lower);
-    return lower;
-}
-
-Node* zigzig_RR(Node *lowest) {
-    zig_R(lowest->parent);
-    return zig_R(lowest);
-}
-
-Node* zigzig_LL(Node *lowest) {
-    zig_L(lowest->parent);
-    return zig_L(lowest);
-}
-
-Node* zigzag_LR(Node *lowest) {
-    zig_L(lowest);
-    return zig_R(lowest);
-}
-
-Node* zigzag_RL(Node *lowest) {
-    zig_R(lowest);
-    return zig_L(lowest);
+    return operations;
 }
 
-Node* propagate_to_root_full(Node *node) {
-    while (node->parent != nullptr) {
-        if (node->parent->parent == nullptr) {
-            if (node->parent->left == node) {
-                //right rotate
-                zig_R(node);
-            } else {
-                //left rotate
-                zig_L(node);
-            }
+/**
+ * Performs all operations on a fresh tree of the given strategy.
+ * @tparam Strategy
+ * @param operations
+ * @return final tree shape, splay counters and time spent
+ */
+template <typename Strategy>
+StrategyResult run_operations(const std::vector<int32_t> &operations) {
+    auto start = std::chrono::steady_clock::now();
+    SplayTree<Strategy> tree;
+    for (int32_t num : operations) {
+        if (num > 0) {
+            tree.insert(num);
         } else {
-            if (node->parent->left == node) {
-                //first rotation right
-                if (node->parent->parent->left == node->parent) {
-                    //second rotation right
-                    zigzig_RR(node);
-                } else {
-                    //second rotation left
-                    zigzag_RL(node);
-                }
-            } else {
-                //first rotation left
-                if(node->parent->parent->left == node->parent) {
-                    //second rotation right
-                    zigzag_LR(node);
-                } else {
-                    //second rotation left;
-                    zigzig_LL(node);
-                }
-            }
+            tree.erase(std::abs(num));
         }
     }
-    return node;
+    TreeShape shape = tree.shape();
+    auto end = std::chrono::steady_clock::now();
+    return {shape, tree.get_stats(), std::chrono::duration<double>(end - start).count()};
 }
 
-Node* propagate_to_root_zig_only(Node *node) {
-    while (node->parent != nullptr) {
-        if (node->parent->left == node) {
-            //right rotate
-            zig_R(node);
-        } else {
-            //left rotate
-            zig_L(node);
+/**
+ * prints statistics of one tree, the depth histogram is aggregated into buckets [2^i - 1, 2^(i+1) - 1)
+ */
+void report(std::ostream &log, const std::string &name, const StrategyResult &result, size_t operation_count) {
+    double ops = operation_count > 0 ? operation_count : 1;
+    const SplayStats &stats = result.stats;
+    log << std::left << std::setw(10) << name << std::right
+        << " height " << std::setw(8) << result.shape.height
+        << " avg depth " << std::setw(10) << result.shape.average_depth
+        << " rotations/op " << std::setw(10) << stats.rotations / ops
+        << " pointers/op " << std::setw(10) << stats.pointer_updates / ops
+        << " ns/op " << std::setw(10) << result.seconds * 1e9 / ops << std::endl;
+    log << std::setw(10) << "" << " steps zig " << stats.zig_steps
+        << " zig-zig " << stats.zig_zig_steps
+        << " zig-zag " << stats.zig_zag_steps << std::endl;
+
+    log << std::setw(10) << "" << " depths";
+    const std::vector<uint64_t> &histogram = result.shape.depth_histogram;
+    for (size_t bucket_start = 0, bucket_end = 1; bucket_start < histogram.size(); bucket_start = bucket_end, bucket_end = 2 * bucket_end + 1) {
+        uint64_t count = 0;
+        for (size_t depth = bucket_start; depth < std::min(bucket_end, histogram.size()); depth++) {
+            count += histogram[depth];
         }
+        log << " [" << bucket_start << "," << bucket_end << "):" << count;
     }
-    return node;
-}
-
-Node* insert_splay_full(Node *tree, Node *insert) {
-    tree = insert_bst(tree, insert);
-    return propagate_to_root_full(insert);
-}
-
-Node* insert_splay_zig(Node *tree, Node* insert) {
-    tree = insert_bst(tree, insert);
-    return propagate_to_root_zig_only(insert);
+    log << std::endl;
 }
 
 /**
- * finds max in tree satisfying the BST property
- * @param tree <- non nullptr
- * @return
+ * Runs the trees on the operations and writes the heights of the full and zig-only trees,
+ * statistics are written to log when stats is set.
+ * @param parallel - every tree on its own thread, otherwise one after another on the calling thread
  */
-Node* find_max(Node *tree) {
-    Node *current = tree;
-    while (current->right != nullptr) {
-        current = current->right;
+void solve(const std::vector<int32_t> &operations, bool stats, bool parallel, std::ostream &output, std::ostream &log) {
+    PROFILE_SCOPE("trees");
+
+    //trees are independent, each one is driven by its own thread
+    std::vector<std::pair<std::string, std::future<StrategyResult>>> runs;
+    auto launch = [&](const std::string &name, StrategyResult (*run)(const std::vector<int32_t> &)) {
+        runs.emplace_back(name, std::async(parallel ? std::launch::async : std::launch::deferred, run, std::cref(operations)));
+    };
+    launch("full", run_operations<FullSplay>);
+    launch("zig", run_operations<ZigOnlySplay>);
+    if (stats) {
+        launch("semi", run_operations<SemiSplay>);
+        launch("top-down", run_operations<TopDownSplay>);
     }
-    return current;
-}
 
-Node* find_min(Node *tree) {
-    Node *current = tree;
-    while (current->left != nullptr) {
-        current = current->left;
+    std::vector<StrategyResult> results;
+    for (auto &run : runs) {
+        results.push_back(run.second.get());
     }
-    return current;
-}
-
-Node* delete_splay_full(Node *tree, uint32_t value) {
-    Node *to_delete = find_bst(tree, value);
-    propagate_to_root_full(to_delete);
-    Node *left = to_delete->left;
-    Node *right = to_delete->right;
-
-    to_delete->left = to_delete->right = nullptr;
 
-    delete to_delete;
-
-    if (left != nullptr) {
-        left->parent = nullptr;
-        Node *max_node = find_max(left);
-        propagate_to_root_full(max_node);
-        max_node->right = right;
-        if (right != nullptr) {
-            right->parent = max_node;
+    output << results[0].shape.height << " " << results[1].shape.height << std::endl;
+    if (stats) {
+        log << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < runs.size(); i++) {
+            report(log, runs[i].first, results[i], operations.size());
         }
-        return max_node;
-    } else if (right != nullptr) {
-        right->parent = nullptr;
-//        Node *min_node = find_min(right);
-//        propagate_to_root_full(min_node);
-//        min_node->left = left; // is always nullptr
-//        return min_node;
-        return right;
-    } else {
-        return nullptr;
     }
 }
 
-Node* delete_splay_zig_only(Node *tree, uint32_t value) {
-    Node *to_delete = find_bst(tree, value);
-    propagate_to_root_zig_only(to_delete);
-    Node *left = to_delete->left;
-    Node *right = to_delete->right;
-
-    to_delete->left = to_delete->right = nullptr;
-
-    delete to_delete;
-
-    if (left != nullptr) {
-        left->parent = nullptr;
-        Node *max_node = find_max(left);
-        propagate_to_root_zig_only(max_node);
-        max_node->right = right;
-        if (right != nullptr) {
-            right->parent = max_node;
-        }
-        return max_node;
-    } else if (right != nullptr) {
-        right->parent = nullptr;
-//        Node *min_node = find_min(right);
-//        propagate_to_root_zig_only(min_node);
-//        min_node->left = left; // is always nullptr
-//        return min_node;
-        return right;
-    } else {
-        return nullptr;
+/**
+ * usage: hw6 [--stats] < input, or hw6 [--stats] --batch [--jobs N] [input...], see batch.h
+ * --stats additionally runs the semi and top-down strategies and reports statistics of all the trees to stderr
+ * In batch mode the trees of an instance run one after another on its worker.
+ */
+int main(int argc, char *argv[]) {
+    bool stats = false;
+    for (int i = 1; i < argc; ++i) {
+        stats |= std::strcmp(argv[i], "--stats") == 0;
     }
-}
-
-int64_t get_height(const Node * tree) {
-    if (tree == nullptr) {
-        return -1;
-    } else {
-        return std::max(get_height(tree->left), get_height(tree->right)) + 1;
+    BatchOptions batch = parse_batch_options(argc, argv);
+    if (batch.enabled) {
+        return run_batch(batch, [stats](std::vector<char> &buffer, std::ostream &output) {
+            std::ostringstream log;
+            solve(parse_operations(buffer), stats, false, output, log);
+            std::cerr << log.str();
+        });
     }
-}
 
-int main() {
-    uint32_t N{};
-    std::cin >> N;
-    Node *full_splay = nullptr;
-    Node *zig_splay = nullptr;
-    for (uint32_t i = 0; i < N; i++) {
-        int32_t num;
-        std::cin >> num;
-        if (num > 0) {
-            full_splay = insert_splay_full(full_splay, new Node(num));
-            zig_splay = insert_splay_zig(zig_splay, new Node(num));
-        } else {
-            full_splay = delete_splay_full(full_splay, std::abs(num));
-            zig_splay = delete_splay_zig_only(zig_splay, std::abs(num));
-        }
+    std::vector<int32_t> operations;
+    {
+        PROFILE_SCOPE("parse");
+        std::vector<char> buffer;
+        read_file(stdin, buffer);
+        operations = parse_operations(buffer);
     }
-    std::cout << get_height(full_splay) << " " << get_height(zig_splay) << std::endl;
-    delete full_splay;
-    delete zig_splay;
+    solve(operations, stats, true, std::cout, std::cerr);
     return 0;
-}
\ No newline at end of file
+}
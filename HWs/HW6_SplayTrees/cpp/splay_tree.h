@@ -0,0 +1,611 @@
+#ifndef CPP_SPLAY_TREE_H
+#define CPP_SPLAY_TREE_H
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <new>
+#include "../../../common/memory_resource.h"
+
+struct Node {
+    Node *left = nullptr;
+    Node *right = nullptr;
+    Node *parent = nullptr;
+    const uint32_t value;
+
+    explicit Node(const uint32_t value) : value(value) {}
+};
+
+/**
+ * Counters of the restructuring work done by a splay strategy.
+ * pointer_updates counts every write to a left/right/parent link.
+ * Top-down splaying counts rotate-and-link as a zig-zig step and a lone link as a zig step.
+ */
+struct SplayStats {
+    uint64_t rotations = 0;
+    uint64_t pointer_updates = 0;
+    uint64_t zig_steps = 0;
+    uint64_t zig_zig_steps = 0;
+    uint64_t zig_zag_steps = 0;
+};
+
+/**
+ * Shape of a tree, depth_histogram[d] is the number of nodes in depth d.
+ * Height of an empty tree is -1.
+ */
+struct TreeShape {
+    uint64_t nodes = 0;
+    int64_t height = -1;
+    double average_depth = 0;
+    std::vector<uint64_t> depth_histogram;
+};
+
+/**
+ * return root of the inserted tree
+ * @param tree
+ * @param insert
+ * @return
+ */
+inline Node* insert_bst(Node *tree, Node *insert, SplayStats &stats) {
+    if (tree == nullptr) {
+        return insert;
+    } else {
+        Node *current = tree;
+        Node *parent = nullptr;
+        while (current != nullptr) {
+            parent = current;
+            current = insert->value < current->value ? current->left : current->right;
+        }
+        if (insert->value < parent->value) {
+            parent->left = insert;
+        } else {
+            parent->right = insert;
+        }
+        insert->parent = parent;
+        stats.pointer_updates += 2;
+        return tree;
+    }
+}
+
+/**
+ * return Node* to the node containing the passed in value, or the last node on the search path
+ * when the value is not in the tree
+ * @param tree <- non nullptr
+ * @param value
+ * @return
+ */
+inline Node* find_bst_or_last(Node *tree, uint32_t value) {
+    Node *current = tree;
+    while (current->value != value) {
+        Node *next = value < current->value ? current->left : current->right;
+        if (next == nullptr) {
+            break;
+        }
+        current = next;
+    }
+    return current;
+}
+
+/**
+ * finds max in tree satisfying the BST property
+ * @param tree <- non nullptr
+ * @return
+ */
+inline Node* find_max(Node *tree) {
+    Node *current = tree;
+    while (current->right != nullptr) {
+        current = current->right;
+    }
+    return current;
+}
+
+inline Node* find_min(Node *tree) {
+    Node *current = tree;
+    while (current->left != nullptr) {
+        current = current->left;
+    }
+    return current;
+}
+
+inline void fix_parent_down_pointer(Node *parent, Node *original, Node *new_child) {
+    if (parent != nullptr) {
+        if (parent->left == original) {
+            parent->left = new_child;
+        } else {
+            parent->right = new_child;
+        }
+    }
+}
+
+inline Node* zig_R(Node *lower, SplayStats &stats) {
+    Node *higher = lower->parent;
+    Node *lower_r = lower->right;
+    lower->parent = higher->parent;
+    lower->right = higher;
+    higher->parent = lower;
+    higher->left = lower_r;
+    stats.rotations++;
+    stats.pointer_updates += 4;
+    if (lower_r != nullptr) {
+        lower_r->parent = higher;
+        stats.pointer_updates++;
+    }
+    if (lower->parent != nullptr) {
+        fix_parent_down_pointer(lower->parent, higher, lower);
+        stats.pointer_updates++;
+    }
+    return lower;
+}
+
+inline Node* zig_L(Node *lower, SplayStats &stats) {
+    Node *higher = lower->parent;
+    Node *lower_l = lower->left;
+    lower->parent = higher->parent;
+    lower->left = higher;
+    higher->parent = lower;
+    higher->right = lower_l;
+    stats.rotations++;
+    stats.pointer_updates += 4;
+    if (lower_l != nullptr) {
+        lower_l->parent = higher;
+        stats.pointer_updates++;
+    }
+    if (lower->parent != nullptr) {
+        fix_parent_down_pointer(lower->parent, higher, lower);
+        stats.pointer_updates++;
+    }
+    return lower;
+}
+
+/**
+ * rotates node above its parent, direction is picked by which child of the parent node is
+ */
+inline Node* zig(Node *node, SplayStats &stats) {
+    return node->parent->left == node ? zig_R(node, stats) : zig_L(node, stats);
+}
+
+/**
+ * Standard bottom-up splay using zig, zig-zig and zig-zag steps.
+ */
+struct FullClimb {
+    /**
+     * moves node to the root
+     * @return new root of the tree
+     */
+    static Node* splay(Node *node, SplayStats &stats) {
+        while (node->parent != nullptr) {
+            Node *parent = node->parent;
+            if (parent->parent == nullptr) {
+                zig(node, stats);
+                stats.zig_steps++;
+            } else if ((parent->left == node) == (parent->parent->left == parent)) {
+                //zig-zig, first rotate the parent, then the node
+                zig(parent, stats);
+                zig(node, stats);
+                stats.zig_zig_steps++;
+            } else {
+                //zig-zag, rotate the node twice
+                zig(node, stats);
+                zig(node, stats);
+                stats.zig_zag_steps++;
+            }
+        }
+        return node;
+    }
+};
+
+/**
+ * Modified splay which moves a node in depth d into the root using d zig rotations.
+ */
+struct ZigClimb {
+    static Node* splay(Node *node, SplayStats &stats) {
+        while (node->parent != nullptr) {
+            zig(node, stats);
+            stats.zig_steps++;
+        }
+        return node;
+    }
+};
+
+/**
+ * Semi-splaying (Sleator, Tarjan). In the zig-zig case only the parent is rotated and splaying continues
+ * from the parent, so the accessed node roughly halves its depth instead of reaching the root.
+ */
+struct SemiClimb {
+    /**
+     * @return new root of the tree, not necessarily node
+     */
+    static Node* splay(Node *node, SplayStats &stats) {
+        while (node->parent != nullptr) {
+            Node *parent = node->parent;
+            if (parent->parent == nullptr) {
+                zig(node, stats);
+                stats.zig_steps++;
+            } else if ((parent->left == node) == (parent->parent->left == parent)) {
+                zig(parent, stats);
+                node = parent;
+                stats.zig_zig_steps++;
+            } else {
+                zig(node, stats);
+                zig(node, stats);
+                stats.zig_zag_steps++;
+            }
+        }
+        return node;
+    }
+};
+
+/**
+ * Strategy which first descends as a plain BST and then climbs back up through the parent pointers
+ * using the Climb policy.
+ * Insert splays the inserted node, erase splays the erased node and joins its subtrees
+ * by splaying the maximum of the left subtree.
+ * @tparam Climb - policy with static Node* splay(Node*, SplayStats&) returning the new root
+ */
+template <typename Climb>
+struct BottomUpSplay {
+    /**
+     * value of insert must not be contained in the tree
+     */
+    static void insert(Node *&tree, Node *insert, SplayStats &stats) {
+        tree = insert_bst(tree, insert, stats);
+        tree = Climb::splay(insert, stats);
+    }
+
+    static Node* find(Node *&tree, uint32_t value, SplayStats &stats) {
+        if (tree == nullptr) {
+            return nullptr;
+        }
+        Node *last = find_bst_or_last(tree, value);
+        tree = Climb::splay(last, stats);
+        return last->value == value ? last : nullptr;
+    }
+
+    static Node* lower_bound(Node *&tree, uint32_t value, SplayStats &stats) {
+        Node *current = tree;
+        Node *last = nullptr;
+        Node *bound = nullptr;
+        while (current != nullptr) {
+            last = current;
+            if (current->value < value) {
+                current = current->right;
+            } else {
+                bound = current;
+                if (current->value == value) {
+                    break;
+                }
+                current = current->left;
+            }
+        }
+        if (last != nullptr) {
+            tree = Climb::splay(last, stats);
+        }
+        return bound;
+    }
+
+    /**
+     * @return unlinked node holding value, nullptr if the value is not in the tree
+     */
+    static Node* erase(Node *&tree, uint32_t value, SplayStats &stats) {
+        Node *to_delete = find(tree, value, stats);
+        if (to_delete == nullptr) {
+            return nullptr;
+        }
+        Node *parent = to_delete->parent;
+        Node *left = to_delete->left;
+        Node *right = to_delete->right;
+        Node *replacement = right;
+
+        to_delete->left = to_delete->right = to_delete->parent = nullptr;
+
+        if (left != nullptr) {
+            left->parent = nullptr;
+            Node *max_node = find_max(left);
+            replacement = Climb::splay(max_node, stats);
+            max_node->right = right;
+            stats.pointer_updates += 2;
+            if (right != nullptr) {
+                right->parent = max_node;
+                stats.pointer_updates++;
+            }
+        }
+        if (replacement != nullptr) {
+            replacement->parent = parent;
+            stats.pointer_updates++;
+        }
+        if (parent == nullptr) {
+            tree = replacement;
+        } else {
+            //only possible for climbs that do not bring the node to the root
+            fix_parent_down_pointer(parent, to_delete, replacement);
+            stats.pointer_updates++;
+        }
+        return to_delete;
+    }
+};
+
+/**
+ * Top-down splay (Sleator, Tarjan), splays in a single pass from the root while building
+ * the left and right trees. Parent pointers are never read nor maintained.
+ */
+struct TopDownSplay {
+    /**
+     * brings value, or the last node on its search path, to the root
+     * @param tree <- non nullptr
+     * @return new root
+     */
+    static Node* splay(Node *tree, uint32_t value, SplayStats &stats) {
+        Node header(0);
+        Node *left_max = &header;
+        Node *right_min = &header;
+        Node *current = tree;
+        while (true) {
+            if (value < current->value) {
+                if (current->left == nullptr) {
+                    break;
+                }
+                if (value < current->left->value) {
+                    //rotate right
+                    Node *lower = current->left;
+                    current->left = lower->right;
+                    lower->right = current;
+                    current = lower;
+                    stats.rotations++;
+                    stats.pointer_updates += 2;
+                    stats.zig_zig_steps++;
+                    if (current->left == nullptr) {
+                        break;
+                    }
+                } else {
+                    stats.zig_steps++;
+                }
+                //link right
+                right_min->left = current;
+                right_min = current;
+                current = current->left;
+                stats.pointer_updates++;
+            } else if (value > current->value) {
+                if (current->right == nullptr) {
+                    break;
+                }
+                if (value > current->right->value) {
+                    //rotate left
+                    Node *lower = current->right;
+                    current->right = lower->left;
+                    lower->left = current;
+                    current = lower;
+                    stats.rotations++;
+                    stats.pointer_updates += 2;
+                    stats.zig_zig_steps++;
+                    if (current->right == nullptr) {
+                        break;
+                    }
+                } else {
+                    stats.zig_steps++;
+                }
+                //link left
+                left_max->right = current;
+                left_max = current;
+                current = current->right;
+                stats.pointer_updates++;
+            } else {
+                break;
+            }
+        }
+        //assemble
+        left_max->right = current->left;
+        right_min->left = current->right;
+        current->left = header.right;
+        current->right = header.left;
+        stats.pointer_updates += 4;
+        return current;
+    }
+
+    /**
+     * value of insert must not be contained in the tree
+     */
+    static void insert(Node *&tree, Node *insert, SplayStats &stats) {
+        if (tree != nullptr) {
+            tree = splay(tree, insert->value, stats);
+            if (insert->value < tree->value) {
+                insert->left = tree->left;
+                insert->right = tree;
+                tree->left = nullptr;
+            } else {
+                insert->right = tree->right;
+                insert->left = tree;
+                tree->right = nullptr;
+            }
+            stats.pointer_updates += 3;
+        }
+        tree = insert;
+    }
+
+    static Node* find(Node *&tree, uint32_t value, SplayStats &stats) {
+        if (tree == nullptr) {
+            return nullptr;
+        }
+        tree = splay(tree, value, stats);
+        return tree->value == value ? tree : nullptr;
+    }
+
+    static Node* lower_bound(Node *&tree, uint32_t value, SplayStats &stats) {
+        if (tree == nullptr) {
+            return nullptr;
+        }
+        tree = splay(tree, value, stats);
+        if (tree->value >= value) {
+            return tree;
+        }
+        return tree->right != nullptr ? find_min(tree->right) : nullptr;
+    }
+
+    static Node* erase(Node *&tree, uint32_t value, SplayStats &stats) {
+        if (find(tree, value, stats) == nullptr) {
+            return nullptr;
+        }
+        Node *to_delete = tree;
+        if (to_delete->left == nullptr) {
+            tree = to_delete->right;
+        } else {
+            //value is larger than everything in the left subtree, so its maximum ends in the root
+            tree = splay(to_delete->left, value, stats);
+            tree->right = to_delete->right;
+            stats.pointer_updates++;
+        }
+        to_delete->left = to_delete->right = nullptr;
+        return to_delete;
+    }
+};
+
+using FullSplay = BottomUpSplay<FullClimb>;
+using ZigOnlySplay = BottomUpSplay<ZigClimb>;
+using SemiSplay = BottomUpSplay<SemiClimb>;
+
+/**
+ * Morris in-order traversal, calls visit(node, depth) for every node.
+ * Uses O(1) extra memory regardless of the tree shape, right pointers of the in-order predecessors
+ * are threaded during the walk and restored before it returns.
+ * @param tree
+ * @param visit
+ */
+template <typename Visit>
+void morris_inorder(Node *tree, Visit visit) {
+    Node *current = tree;
+    uint64_t depth = 0;
+    while (current != nullptr) {
+        if (current->left == nullptr) {
+            visit(current, depth);
+            current = current->right;
+            depth++;
+        } else {
+            Node *predecessor = current->left;
+            uint64_t steps = 1;
+            while (predecessor->right != nullptr && predecessor->right != current) {
+                predecessor = predecessor->right;
+                steps++;
+            }
+            if (predecessor->right == nullptr) {
+                predecessor->right = current;
+                current = current->left;
+                depth++;
+            } else {
+                //came back through the thread, depth is depth of the predecessor + 1
+                predecessor->right = nullptr;
+                depth -= steps + 1;
+                visit(current, depth);
+                current = current->right;
+                depth++;
+            }
+        }
+    }
+}
+
+/**
+ * height, average depth and depth histogram in a single traversal
+ */
+inline TreeShape get_shape(Node *tree) {
+    TreeShape shape;
+    uint64_t depth_sum = 0;
+    morris_inorder(tree, [&](const Node *, uint64_t depth) {
+        if (depth >= shape.depth_histogram.size()) {
+            shape.depth_histogram.resize(depth + 1, 0);
+        }
+        shape.depth_histogram[depth]++;
+        shape.nodes++;
+        depth_sum += depth;
+    });
+    shape.height = (int64_t) shape.depth_histogram.size() - 1;
+    shape.average_depth = shape.nodes > 0 ? (double) depth_sum / shape.nodes : 0;
+    return shape;
+}
+
+inline int64_t get_height(Node *tree) {
+    int64_t height = -1;
+    morris_inorder(tree, [&height](const Node *, uint64_t depth) {
+        height = std::max(height, (int64_t) depth);
+    });
+    return height;
+}
+
+/**
+ * Splay tree owning its nodes, splaying is selected at compile time.
+ * Nodes come from a pool owned by the tree, erased nodes are reused by later inserts.
+ * @tparam Strategy - FullSplay, ZigOnlySplay, SemiSplay or TopDownSplay
+ */
+template <typename Strategy>
+class SplayTree {
+public:
+    SplayTree() = default;
+
+    SplayTree(const SplayTree &other) = delete;
+
+    SplayTree& operator=(const SplayTree &other) = delete;
+
+    ~SplayTree() {
+        clear();
+    }
+
+    /**
+     * value must not be contained in the tree
+     */
+    void insert(uint32_t value) {
+        Strategy::insert(root, new(nodes.allocate(sizeof(Node), alignof(Node))) Node(value), stats);
+    }
+
+    /**
+     * @return whether value was contained in the tree
+     */
+    bool erase(uint32_t value) {
+        Node *erased = Strategy::erase(root, value, stats);
+        if (erased != nullptr) {
+            nodes.deallocate(erased, sizeof(Node), alignof(Node));
+        }
+        return erased != nullptr;
+    }
+
+    bool find(uint32_t value) {
+        return Strategy::find(root, value, stats) != nullptr;
+    }
+
+    /**
+     * @return node with the smallest value not less than value, nullptr if there is none
+     */
+    const Node* lower_bound(uint32_t value) {
+        return Strategy::lower_bound(root, value, stats);
+    }
+
+    /**
+     * does not splay, but temporarily threads the tree so it is not const
+     */
+    int64_t height() {
+        return get_height(root);
+    }
+
+    TreeShape shape() {
+        return get_shape(root);
+    }
+
+    const Node* get_root() const {
+        return root;
+    }
+
+    const SplayStats& get_stats() const {
+        return stats;
+    }
+
+    /**
+     * nodes are trivially destructible, so all of them are returned to the pool at once
+     */
+    void clear() {
+        root = nullptr;
+        nodes.release();
+    }
+
+private:
+    Node *root = nullptr;
+    SplayStats stats;
+    PoolResource nodes;
+};
+
+#endif //CPP_SPLAY_TREE_H
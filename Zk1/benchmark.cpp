@@ -0,0 +1,73 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include "prefix_tree.h"
+
+using namespace std;
+
+/**
+ * Thread scaling of the sharded build, times of every phase are medians over the repetitions.
+ * usage: benchmark input [max threads] [repetitions]
+ */
+
+double median(vector<double> values) {
+    sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "usage: benchmark input [max threads] [repetitions]" << endl;
+        return 1;
+    }
+    FILE *input = fopen(argv[1], "rb");
+    if (input == nullptr) {
+        cerr << "cannot open " << argv[1] << endl;
+        return 1;
+    }
+    vector<char> buffer = read_all(input);
+    fclose(input);
+    unsigned max_threads = argc > 2 ? (unsigned) atoi(argv[2]) : max(1u, thread::hardware_concurrency());
+    int repetitions = argc > 3 ? atoi(argv[3]) : 5;
+
+    cout << fixed << setprecision(2);
+    cout << setw(8) << "threads" << setw(12) << "parse ms" << setw(12) << "build ms" << setw(12) << "count ms"
+         << setw(12) << "total ms" << setw(10) << "speedup" << setw(10) << "result" << endl;
+    double single_thread_total = 0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        vector<double> parse_ms, build_ms, count_ms, total_ms;
+        uint64_t result = 0;
+        for (int repetition = 0; repetition < repetitions; ++repetition) {
+            auto start = chrono::steady_clock::now();
+            vector<WordRef> tokens = tokenize(buffer, threads);
+            string alphabet(tokens[0].begin, tokens[0].length);
+            size_t position = 4;
+            EvaluationLists lists = read_evaluation_lists(tokens, position, to_number(tokens[1]));
+            auto parsed = chrono::steady_clock::now();
+            ShardedPrefixTree tree = build_sharded(alphabet, lists, threads);
+            auto built = chrono::steady_clock::now();
+            vector<Query> queries{{to_number(tokens[3]), (uint32_t) to_number(tokens[2])}};
+            result = count_accepted_proposals(tree, queries, threads)[0];
+            auto counted = chrono::steady_clock::now();
+
+            parse_ms.push_back(chrono::duration<double, milli>(parsed - start).count());
+            build_ms.push_back(chrono::duration<double, milli>(built - parsed).count());
+            count_ms.push_back(chrono::duration<double, milli>(counted - built).count());
+            total_ms.push_back(chrono::duration<double, milli>(counted - start).count());
+        }
+        if (threads == 1) {
+            single_thread_total = median(total_ms);
+        }
+        cout << setw(8) << threads << setw(12) << median(parse_ms) << setw(12) << median(build_ms)
+             << setw(12) << median(count_ms) << setw(12) << median(total_ms)
+             << setw(10) << single_thread_total / median(total_ms) << setw(10) << result << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "../common/generator.h"
+
+/**
+ * Committee evaluation lists, scale 1 is the size of pub07 (11 letters, 7000 members, about 316000 words
+ * of 5.5 letters on average). Words are a stem from a shared pool followed by a short random suffix,
+ * so the lists of different members share long prefixes, and some words repeat within a list.
+ * Lists are written member by member, only the stem pool is kept in memory.
+ * usage: generator [scale] [seed] [alphabet size = 11] [stems = 2000]
+ */
+int main(int argc, char *argv[]) {
+    GeneratorArguments arguments(argc, argv);
+    Random random(arguments.seed);
+    uint32_t alphabet_size = argc > 3 ? (uint32_t) std::strtoul(argv[3], nullptr, 10) : 11;
+    uint32_t stem_count = argc > 4 ? (uint32_t) std::strtoul(argv[4], nullptr, 10) : 2000;
+    alphabet_size = std::max<uint32_t>(2, std::min<uint32_t>(26, alphabet_size));
+    stem_count = std::max<uint32_t>(1, stem_count);
+
+    std::string alphabet = "abcdefghijklmnopqrstuvwxyz";
+    for (size_t i = alphabet.size() - 1; i > 0; --i) {
+        std::swap(alphabet[i], alphabet[random.below(i + 1)]);
+    }
+    alphabet.resize(alphabet_size);
+
+    uint64_t members = std::max<uint64_t>(1, (uint64_t) std::llround(7000 * arguments.scale));
+    uint64_t min_approve = 1 + random.below(std::min<uint64_t>(members, 20));
+    uint64_t prefix_length = 1 + random.below(10000);
+
+    std::vector<std::string> stems(stem_count);
+    for (std::string &stem : stems) {
+        stem.resize((size_t) random.between(1, 5));
+        for (char &letter : stem) {
+            letter = alphabet[random.below(alphabet_size)];
+        }
+    }
+
+    Output out;
+    out << alphabet << ' ' << members << ' ' << min_approve << ' ' << prefix_length << '\n';
+    std::string word;
+    for (uint64_t member = 0; member < members; ++member) {
+        uint64_t list_length = (uint64_t) random.between(1, 89);
+        out << list_length << '\n';
+        for (uint64_t i = 0; i < list_length; ++i) {
+            if (i == 0 || !random.chance(0.2)) {
+                word = stems[random.below(stem_count)];
+                while (random.chance(0.6)) {
+                    word += alphabet[random.below(alphabet_size)];
+                }
+            }
+            out << word << '\n';
+        }
+    }
+    return 0;
+}
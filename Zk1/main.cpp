@@ -1,113 +1,110 @@
 #include <iostream>
 #include <cstdint>
+#include <cstdlib>
 #include <vector>
-#include <unordered_map>
-#include <map>
-#include <set>
-#include <memory>
+#include <string>
+#include <sstream>
+#include <thread>
+#include "prefix_tree.h"
+#include "radix_tree.h"
+#include "../common/instrumentation.h"
+#include "../common/batch.h"
 
 using namespace std;
 
-struct Node {
-    bool final = false;
-    uint64_t committee_count = 0;
-    set<uint32_t> final_to_here;
-    set<uint32_t> committee_members;
-    unordered_map<char, Node*> children;
+struct Options {
+    bool memory = false;
+    bool more_queries = false;
+    bool radix = false;
+    unsigned threads = 1;
 };
 
-Node* tree = new Node();
-
-void update_later_final(Node *root, uint32_t member) {
-    if (root->final) {
-        root->final_to_here.insert(member);
+/**
+ * Counts the accepted proposals of one input, the buffer holds the whole input and the words point into it.
+ */
+int solve(const vector<char> &buffer, const Options &options, ostream &output, ostream &log) {
+    PROFILE_START(phase, "tokenize");
+    vector<WordRef> tokens = tokenize(buffer, options.threads);
+    if (tokens.size() < 4) {
+        return 1;
     }
+    string alphabet(tokens[0].begin, tokens[0].length);
+    uint32_t committee_members = to_number(tokens[1]);
+    uint32_t min_approve_count = to_number(tokens[2]);
+    uint32_t prefix_length = to_number(tokens[3]);
 
-    for (auto char_node_ptr_pair : root->children) {
-        Node* child = char_node_ptr_pair.second;
-        update_later_final(child, member);
-    }
-}
+    PROFILE_NEXT(phase, "evaluation lists");
+    size_t position = 4;
+    EvaluationLists lists = read_evaluation_lists(tokens, position, committee_members);
 
-void add_to_prefix_tree(string &prefix, uint32_t member) {
-    Node *current = tree;
-    set<uint32_t> final_along_way;
-    final_along_way.insert(member);
-    for (size_t idx = 0; idx < prefix.size(); ++idx) {
-        Node *next = current->children[prefix[idx]];
-        if (next == nullptr) {
-            next = new Node();
-            current->children[prefix[idx]] = next;
-        }
-        if (next->committee_members.find(member) == next->committee_members.end()) {
-            next->committee_members.insert(member);
-            next->committee_count++;
-        }
-        for (uint32_t memb : next->final_to_here) {
-            final_along_way.insert(memb);
-        }
-        current = next;
+    vector<Query> queries{{prefix_length, min_approve_count}};
+    while (options.more_queries && position + 1 < tokens.size()) {
+        queries.push_back({to_number(tokens[position]), (uint32_t) to_number(tokens[position + 1])});
+        position += 2;
     }
-    for (uint32_t memb: final_along_way) {
-        current->final_to_here.insert(memb);
-    }
-    current->final = true;
-    update_later_final(current, member);
-}
-
 
-uint64_t get_prefix_counts_of_length_k(Node *root, uint64_t cur_depth, uint64_t k, uint64_t alphabet_size, uint64_t committee_approval_count) {
-    size_t final_size_to_here = root->final_to_here.size();
-    if (final_size_to_here >= committee_approval_count) {
-        uint64_t cnt = 1;
-        int64_t remaining = k - cur_depth;
-        if (remaining > 0) {
-            for (uint64_t i = 0; i < remaining; ++i) {
-                cnt = (cnt*alphabet_size)%100000;
-            }
-        }
-        return cnt;
+    vector<uint64_t> counts;
+    size_t nodes, bytes;
+    if (options.radix) {
+        PROFILE_NEXT(phase, "build");
+        RadixTree tree = build_radix(alphabet, lists);
+        propagate_final_to_here(tree, committee_members);
+        PROFILE_NEXT(phase, "count");
+        counts = count_accepted_proposals(tree, queries);
+        nodes = tree.nodes.size();
+        bytes = tree.memory_bytes();
     } else {
-        uint64_t cnt = 0;
-        for (auto char_node_ptr_pair : root->children) {
-            Node* child = char_node_ptr_pair.second;
-//            cnt = (cnt + get_prefix_counts_of_length_k(child, cur_depth+1, k, alphabet_size, committee_approval_count))%100000;
-            if (!root->final || child->committee_count >= committee_approval_count - final_size_to_here) {
-                cnt = (cnt + get_prefix_counts_of_length_k(child, cur_depth+1, k, alphabet_size, committee_approval_count))%100000;
-            }
-        }
-        return cnt;
+        PROFILE_NEXT(phase, "build");
+        ShardedPrefixTree tree = build_sharded(alphabet, lists, options.threads);
+        PROFILE_NEXT(phase, "count");
+        counts = count_accepted_proposals(tree, queries, options.threads);
+        nodes = tree.node_count();
+        bytes = tree.memory_bytes();
     }
+    for (uint64_t count : counts) {
+        output << count << endl;
+    }
+    if (options.memory) {
+        log << "nodes " << nodes << " bytes " << bytes << " words " << lists.words.size()
+            << " bytes/word " << (double) bytes / max<size_t>(lists.words.size(), 1) << endl;
+    }
+    return 0;
 }
 
-int main() {
-    std::ios_base::sync_with_stdio(false);
-    map<string, uint64_t> counts;
-
-    string alphabet;
-    uint32_t committee_members, min_approve_count, prefix_length;
-
-    cin >> alphabet >> committee_members >> min_approve_count >> prefix_length;
-
-    for (size_t committee_member = 0; committee_member < committee_members; ++committee_member) {
-        set<string> member_used;
-        uint32_t member_list_length;
-        cin >> member_list_length;
-        for (size_t member_string_idx = 0; member_string_idx < member_list_length; ++member_string_idx) {
-            string cur_string;
-            cin >> cur_string;
-            if (member_used.find(cur_string) == member_used.end()) {
-                member_used.insert(cur_string);
-                uint64_t &cur_count = counts[cur_string];
-                add_to_prefix_tree(cur_string, committee_member);
-//                if (cur_count == min_approve_count - 1) {
-//
-//                }
-                cur_count++;
-            }
+/**
+ * usage: zk1 [--memory] [--queries] [--threads N] [--radix] < input,
+ * or zk1 [options] --batch [--jobs N] [input...], see batch.h
+ * --memory prints the size of the tree to stderr
+ * --queries reads further "K D" pairs after the evaluation lists until the end of input
+ * and prints one line per query, the one from the first line first
+ * --threads number of threads for parsing, building and counting, all hardware threads by default,
+ * in batch mode the hardware threads are divided among the jobs
+ * --radix uses the path compressed tree built from the sorted words, only parsing is parallel
+ */
+int main(int argc, char *argv[]) {
+    Options options;
+    BatchOptions batch = parse_batch_options(argc, argv);
+    options.threads = max(1u, thread::hardware_concurrency() / (batch.enabled ? batch.jobs : 1));
+    for (int i = 1; i < argc; ++i) {
+        options.memory |= string(argv[i]) == "--memory";
+        options.more_queries |= string(argv[i]) == "--queries";
+        options.radix |= string(argv[i]) == "--radix";
+        if (string(argv[i]) == "--threads" && i + 1 < argc) {
+            options.threads = max(1, atoi(argv[++i]));
         }
     }
-    cout << get_prefix_counts_of_length_k(tree, 0, prefix_length, alphabet.size(), min_approve_count) << endl;
+    if (batch.enabled) {
+        return run_batch(batch, [&options](vector<char> &buffer, ostream &output) {
+            ostringstream log;
+            solve(buffer, options, output, log);
+            cerr << log.str();
+        });
+    }
 
-    return 0;
-}
\ No newline at end of file
+    vector<char> buffer;
+    {
+        PROFILE_SCOPE("read");
+        buffer = read_all(stdin);
+    }
+    return solve(buffer, options, cout, cerr);
+}
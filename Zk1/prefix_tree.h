@@ -0,0 +1,536 @@
+#ifndef ZK1_PREFIX_TREE_H
+#define ZK1_PREFIX_TREE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <array>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <thread>
+#include <atomic>
+#include <unordered_set>
+#include <memory>
+#include "../common/memory_resource.h"
+
+constexpr uint32_t NO_CHILD = 0; // root is never a child
+constexpr uint32_t NO_MEMBER = UINT32_MAX;
+constexpr uint32_t NO_SET = UINT32_MAX;
+
+// members whose word ends in a node, allocated from the arena of the tree
+using MemberSet = std::vector<uint32_t, ResourceAllocator<uint32_t>>;
+
+struct Node {
+    uint32_t committee_count = 0;
+    uint32_t last_member = NO_MEMBER; // last member counted in committee_count, members are added in increasing order
+    uint32_t final_set = NO_SET; // index into PrefixTree::final_sets, only final nodes have one
+    uint32_t final_to_here_count = 0; // members approving some prefix of the node, valid after propagate_final_to_here
+};
+
+/**
+ * Prefix tree stored in contiguous vectors. Children of node n are children[n*alphabet_size + rank of the char],
+ * final nodes own a sorted vector of members whose word ends in the node.
+ * The member vectors grow in an arena freed with the tree, the arena is on the heap so the tree stays movable.
+ */
+class PrefixTree {
+public:
+    uint32_t alphabet_size;
+    std::array<uint8_t, 256> rank{};
+    std::vector<Node> nodes;
+    std::vector<uint32_t> children;
+    std::unique_ptr<MonotonicArena> final_arena;
+    std::vector<MemberSet> final_sets;
+
+    explicit PrefixTree(const std::string &alphabet)
+            : alphabet_size(alphabet.size()), final_arena(new MonotonicArena()) {
+        for (size_t i = 0; i < alphabet.size(); ++i) {
+            rank[(uint8_t) alphabet[i]] = i;
+        }
+        add_node();
+    }
+
+    uint32_t add_node() {
+        nodes.emplace_back();
+        children.resize(children.size() + alphabet_size, NO_CHILD);
+        return nodes.size() - 1;
+    }
+
+    uint32_t &child(uint32_t node, char c) {
+        return children[(size_t) node * alphabet_size + rank[(uint8_t) c]];
+    }
+
+    bool is_final(uint32_t node) const {
+        return nodes[node].final_set != NO_SET;
+    }
+
+    const MemberSet &final_here(uint32_t node) const {
+        return final_sets[nodes[node].final_set];
+    }
+
+    template <typename Visit>
+    void for_each_child(uint32_t node, Visit visit) const {
+        for (uint32_t c = 0; c < alphabet_size; ++c) {
+            uint32_t child = children[(size_t) node * alphabet_size + c];
+            if (child != NO_CHILD) {
+                visit(child);
+            }
+        }
+    }
+
+    uint32_t child_depth(uint32_t, uint32_t parent_depth) const {
+        return parent_depth + 1;
+    }
+
+    size_t memory_bytes() const {
+        size_t bytes = nodes.capacity() * sizeof(Node) + children.capacity() * sizeof(uint32_t)
+                + final_sets.capacity() * sizeof(MemberSet);
+        return bytes + final_arena->reserved_bytes();
+    }
+};
+
+/**
+ * Adds the word of member to the tree, only the members ending in the node are recorded,
+ * approvals of the prefixes are computed for all words at once by propagate_final_to_here.
+ * @param tree
+ * @param prefix
+ * @param length
+ * @param member - members must be added in increasing order
+ */
+inline void add_to_prefix_tree(PrefixTree &tree, const char *prefix, size_t length, uint32_t member) {
+    uint32_t current = 0;
+    for (size_t idx = 0; idx < length; ++idx) {
+        uint32_t next = tree.child(current, prefix[idx]);
+        if (next == NO_CHILD) {
+            next = tree.add_node();
+            tree.child(current, prefix[idx]) = next;
+        }
+        Node &next_node = tree.nodes[next];
+        if (next_node.last_member != member) {
+            next_node.last_member = member;
+            next_node.committee_count++;
+        }
+        current = next;
+    }
+    if (!tree.is_final(current)) {
+        tree.nodes[current].final_set = tree.final_sets.size();
+        tree.final_sets.emplace_back(tree.final_arena.get());
+    }
+    MemberSet &final_here = tree.final_sets[tree.nodes[current].final_set];
+    if (final_here.empty() || final_here.back() != member) {
+        final_here.push_back(member);
+    }
+}
+
+inline void add_to_prefix_tree(PrefixTree &tree, const std::string &prefix, uint32_t member) {
+    add_to_prefix_tree(tree, prefix.data(), prefix.size(), member);
+}
+
+/**
+ * Single top-down pass computing final_to_here_count of every final node, the number of distinct members
+ * with a word ending in the node or in one of its ancestors.
+ * Depth first, a member is counted while the walk is below some of its final nodes,
+ * so the work is linear in the tree size plus the number of recorded members.
+ * @tparam Tree - PrefixTree or RadixTree
+ * @param tree
+ * @param committee_members
+ */
+template <typename Tree>
+void propagate_final_to_here(Tree &tree, uint32_t committee_members) {
+    std::vector<uint32_t> ends_above(committee_members, 0);
+    uint32_t distinct = 0;
+    // node and whether it is being left
+    std::vector<std::pair<uint32_t, bool>> stack{{0, false}};
+    while (!stack.empty()) {
+        uint32_t node;
+        bool leaving;
+        std::tie(node, leaving) = stack.back();
+        stack.pop_back();
+        if (leaving) {
+            for (uint32_t member : tree.final_here(node)) {
+                if (--ends_above[member] == 0) {
+                    distinct--;
+                }
+            }
+            continue;
+        }
+        if (tree.is_final(node)) {
+            for (uint32_t member : tree.final_here(node)) {
+                if (ends_above[member]++ == 0) {
+                    distinct++;
+                }
+            }
+            stack.emplace_back(node, true);
+        }
+        tree.nodes[node].final_to_here_count = distinct;
+        tree.for_each_child(node, [&stack](uint32_t child) {
+            stack.emplace_back(child, false);
+        });
+    }
+}
+
+struct Query {
+    uint64_t prefix_length;
+    uint32_t min_approve_count;
+};
+
+/**
+ * @return powers[i] = base^i % 100000 for i in [0, max_exponent]
+ */
+inline std::vector<uint32_t> power_table(uint64_t base, uint64_t max_exponent) {
+    std::vector<uint32_t> powers(max_exponent + 1);
+    powers[0] = 1;
+    for (uint64_t i = 1; i <= max_exponent; ++i) {
+        powers[i] = (uint32_t) ((powers[i-1] * base) % 100000);
+    }
+    return powers;
+}
+
+/**
+ * frontier[threshold index][depth] is the number of frontier nodes of the threshold in the depth, modulo 100000
+ */
+struct FrontierCounts {
+    std::vector<uint32_t> thresholds;
+    uint64_t max_length = 0;
+    std::vector<std::vector<uint32_t>> frontier;
+
+    explicit FrontierCounts(const std::vector<Query> &queries) {
+        for (const Query &query : queries) {
+            thresholds.push_back(query.min_approve_count);
+            max_length = std::max(max_length, query.prefix_length);
+        }
+        std::sort(thresholds.begin(), thresholds.end());
+        thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+        frontier.assign(thresholds.size(), std::vector<uint32_t>(max_length + 1, 0));
+    }
+
+    void merge(const FrontierCounts &other) {
+        for (size_t t = 0; t < frontier.size(); ++t) {
+            for (size_t depth = 0; depth <= max_length; ++depth) {
+                frontier[t][depth] = (frontier[t][depth] + other.frontier[t][depth]) % 100000;
+            }
+        }
+    }
+};
+
+/**
+ * Iterative walk of the tree adding its frontier nodes to counts.
+ * final_to_here_count never decreases along a path, so for approval threshold D the proposals are counted
+ * at the first node on the path reaching D, the node frontier of D.
+ * Subtrees are skipped when their members cannot reach the next threshold or they are deeper than every query.
+ * @tparam Tree - PrefixTree or RadixTree
+ * @param tree - after propagate_final_to_here
+ * @param counts
+ */
+template <typename Tree>
+void add_frontier_counts(const Tree &tree, FrontierCounts &counts) {
+    const std::vector<uint32_t> &thresholds = counts.thresholds;
+    struct Visit {
+        uint32_t node;
+        uint32_t depth;
+        uint32_t approvals; // final_to_here_count of the deepest final ancestor
+    };
+    std::vector<Visit> stack{{0, 0, 0}};
+    while (!stack.empty()) {
+        Visit visit = stack.back();
+        stack.pop_back();
+        uint32_t approvals = visit.approvals;
+        if (tree.is_final(visit.node)) {
+            approvals = std::max(approvals, tree.nodes[visit.node].final_to_here_count);
+        }
+        size_t next_threshold = std::upper_bound(thresholds.begin(), thresholds.end(), visit.approvals) - thresholds.begin();
+        for (; next_threshold < thresholds.size() && thresholds[next_threshold] <= approvals; ++next_threshold) {
+            uint32_t &count = counts.frontier[next_threshold][visit.depth];
+            count = (count + 1) % 100000;
+        }
+        if (next_threshold == thresholds.size()) {
+            continue;
+        }
+        tree.for_each_child(visit.node, [&](uint32_t child) {
+            uint32_t depth = tree.child_depth(child, visit.depth);
+            if (depth <= counts.max_length
+                && (uint64_t) approvals + tree.nodes[child].committee_count >= thresholds[next_threshold]) {
+                stack.push_back({child, depth, approvals});
+            }
+        });
+    }
+}
+
+/**
+ * A proposal of length k accepted through a frontier node in depth d is any of alphabet_size^(k - d) completions.
+ * With no approvals needed every proposal is accepted, the root would be the frontier of every shard,
+ * so such queries are answered alphabet_size^k without the frontier counts.
+ * @return number of accepted proposals modulo 100000 for each query
+ */
+inline std::vector<uint64_t> answer_queries(const FrontierCounts &counts, const std::vector<Query> &queries, uint32_t alphabet_size) {
+    std::vector<uint32_t> powers = power_table(alphabet_size, counts.max_length);
+    std::vector<uint64_t> answers;
+    for (const Query &query : queries) {
+        if (query.min_approve_count == 0) {
+            answers.push_back(powers[query.prefix_length]);
+            continue;
+        }
+        size_t threshold = std::lower_bound(counts.thresholds.begin(), counts.thresholds.end(), query.min_approve_count)
+                - counts.thresholds.begin();
+        uint64_t cnt = 0;
+        for (uint64_t depth = 0; depth <= query.prefix_length; ++depth) {
+            cnt = (cnt + (uint64_t) counts.frontier[threshold][depth] * powers[query.prefix_length - depth]) % 100000;
+        }
+        answers.push_back(cnt);
+    }
+    return answers;
+}
+
+/**
+ * Counts accepted proposals for all queries in one walk of the tree.
+ * @tparam Tree - PrefixTree or RadixTree
+ * @param tree - after propagate_final_to_here
+ * @param queries
+ * @return number of accepted proposals modulo 100000 for each query
+ */
+template <typename Tree>
+std::vector<uint64_t> count_accepted_proposals(const Tree &tree, const std::vector<Query> &queries) {
+    FrontierCounts counts(queries);
+    add_frontier_counts(tree, counts);
+    return answer_queries(counts, queries, tree.alphabet_size);
+}
+
+/**
+ * Runs task(index) for every index in [0, tasks) on at most threads threads.
+ */
+template <typename Task>
+void parallel_for(size_t tasks, unsigned threads, Task task) {
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t index = next++; index < tasks; index = next++) {
+            task(index);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < std::min<size_t>(threads, tasks); ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : workers) {
+        thread.join();
+    }
+}
+
+/**
+ * Whitespace delimited token of the input buffer.
+ */
+struct WordRef {
+    const char *begin;
+    uint32_t length;
+
+    bool operator==(const WordRef &other) const {
+        return length == other.length && std::equal(begin, begin + length, other.begin);
+    }
+};
+
+struct WordRefHash {
+    size_t operator()(const WordRef &word) const {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (uint32_t i = 0; i < word.length; ++i) {
+            hash = (hash ^ (uint8_t) word.begin[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+};
+
+inline uint64_t to_number(const WordRef &word) {
+    uint64_t number = 0;
+    for (uint32_t i = 0; i < word.length; ++i) {
+        number = number * 10 + (word.begin[i] - '0');
+    }
+    return number;
+}
+
+inline std::vector<char> read_all(FILE *input) {
+    std::vector<char> buffer;
+    char chunk[1 << 16];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), input)) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + read);
+    }
+    return buffer;
+}
+
+/**
+ * Splits the buffer into whitespace delimited tokens, chunks of the buffer are scanned in parallel.
+ * @param buffer
+ * @param threads
+ * @return tokens in input order
+ */
+inline std::vector<WordRef> tokenize(const std::vector<char> &buffer, unsigned threads) {
+    auto is_space = [](char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; };
+    const char *begin = buffer.data();
+    const char *end = begin + buffer.size();
+
+    // chunk boundaries are moved forward to whitespace, so no token is split
+    std::vector<const char*> bounds{begin};
+    size_t chunk = std::max<size_t>(buffer.size() / std::max(threads, 1u), 1);
+    for (unsigned i = 1; i < threads; ++i) {
+        const char *bound = std::max(bounds.back(), std::min(end, begin + i * chunk));
+        while (bound != end && !is_space(*bound)) {
+            bound++;
+        }
+        bounds.push_back(bound);
+    }
+    bounds.push_back(end);
+
+    std::vector<std::vector<WordRef>> chunk_tokens(bounds.size() - 1);
+    parallel_for(chunk_tokens.size(), threads, [&](size_t i) {
+        const char *cur = bounds[i];
+        while (cur != bounds[i + 1]) {
+            while (cur != bounds[i + 1] && is_space(*cur)) {
+                cur++;
+            }
+            const char *token = cur;
+            while (cur != bounds[i + 1] && !is_space(*cur)) {
+                cur++;
+            }
+            if (cur != token) {
+                chunk_tokens[i].push_back({token, (uint32_t) (cur - token)});
+            }
+        }
+    });
+
+    std::vector<WordRef> tokens;
+    for (auto &part : chunk_tokens) {
+        tokens.insert(tokens.end(), part.begin(), part.end());
+    }
+    return tokens;
+}
+
+/**
+ * Words of the evaluation lists in input order, words[i] belongs to members[i].
+ */
+struct EvaluationLists {
+    uint32_t committee_members = 0;
+    std::vector<WordRef> words;
+    std::vector<uint32_t> members;
+};
+
+/**
+ * Reads committee_members evaluation lists from tokens starting at position, position ends after the lists.
+ */
+inline EvaluationLists read_evaluation_lists(const std::vector<WordRef> &tokens, size_t &position, uint32_t committee_members) {
+    EvaluationLists lists;
+    lists.committee_members = committee_members;
+    for (uint32_t member = 0; member < committee_members && position < tokens.size(); ++member) {
+        uint64_t member_list_length = to_number(tokens[position++]);
+        for (uint64_t i = 0; i < member_list_length && position < tokens.size(); ++i) {
+            lists.words.push_back(tokens[position++]);
+            lists.members.push_back(member);
+        }
+    }
+    return lists;
+}
+
+/**
+ * Prefix tree split into shards by the first character of the words. Roots are never final,
+ * so every shard is an independent subtree of the whole tree and per-shard counts add up.
+ */
+struct ShardedPrefixTree {
+    std::vector<PrefixTree> shards;
+
+    size_t node_count() const {
+        size_t nodes = 0;
+        for (const PrefixTree &shard : shards) {
+            nodes += shard.nodes.size() - 1;
+        }
+        return nodes + 1;
+    }
+
+    size_t memory_bytes() const {
+        size_t bytes = 0;
+        for (const PrefixTree &shard : shards) {
+            bytes += shard.memory_bytes();
+        }
+        return bytes;
+    }
+};
+
+/**
+ * Builds the tree on threads threads. First characters are assigned to at most threads shards balancing
+ * the number of words, every shard inserts its words in member order, skipping repeated words of a member,
+ * and then propagates the approvals within the shard.
+ * @param alphabet
+ * @param lists
+ * @param threads
+ * @return
+ */
+inline ShardedPrefixTree build_sharded(const std::string &alphabet, const EvaluationLists &lists, unsigned threads) {
+    uint32_t shard_count = std::max(1u, std::min<uint32_t>(threads, alphabet.size()));
+    std::array<uint8_t, 256> rank{};
+    for (size_t i = 0; i < alphabet.size(); ++i) {
+        rank[(uint8_t) alphabet[i]] = i;
+    }
+
+    std::vector<uint64_t> first_char_words(alphabet.size(), 0);
+    for (const WordRef &word : lists.words) {
+        first_char_words[rank[(uint8_t) word.begin[0]]]++;
+    }
+    // largest first, each to the least loaded shard
+    std::vector<uint32_t> by_words(alphabet.size());
+    std::iota(by_words.begin(), by_words.end(), 0);
+    std::sort(by_words.begin(), by_words.end(), [&](uint32_t a, uint32_t b) {
+        return first_char_words[a] > first_char_words[b];
+    });
+    std::vector<uint64_t> shard_words(shard_count, 0);
+    std::vector<uint32_t> shard_of(alphabet.size());
+    for (uint32_t c : by_words) {
+        size_t lightest = std::min_element(shard_words.begin(), shard_words.end()) - shard_words.begin();
+        shard_of[c] = lightest;
+        shard_words[lightest] += first_char_words[c];
+    }
+
+    std::vector<std::vector<uint32_t>> shard_word_indices(shard_count);
+    for (size_t i = 0; i < lists.words.size(); ++i) {
+        shard_word_indices[shard_of[rank[(uint8_t) lists.words[i].begin[0]]]].push_back(i);
+    }
+
+    ShardedPrefixTree tree;
+    tree.shards.reserve(shard_count);
+    for (uint32_t s = 0; s < shard_count; ++s) {
+        tree.shards.emplace_back(alphabet);
+    }
+    parallel_for(shard_count, threads, [&](size_t s) {
+        PrefixTree &shard = tree.shards[s];
+        // words of one member at a time, the set nodes are recycled through the pool when the member changes
+        PoolResource used_nodes;
+        std::unordered_set<WordRef, WordRefHash, std::equal_to<WordRef>, ResourceAllocator<WordRef>>
+                member_used(64, WordRefHash(), std::equal_to<WordRef>(), &used_nodes);
+        uint32_t current_member = NO_MEMBER;
+        for (uint32_t i : shard_word_indices[s]) {
+            if (lists.members[i] != current_member) {
+                current_member = lists.members[i];
+                member_used.clear();
+            }
+            if (member_used.insert(lists.words[i]).second) {
+                add_to_prefix_tree(shard, lists.words[i].begin, lists.words[i].length, current_member);
+            }
+        }
+        propagate_final_to_here(shard, lists.committee_members);
+    });
+    return tree;
+}
+
+/**
+ * Counts accepted proposals of all queries, shards are walked in parallel.
+ */
+inline std::vector<uint64_t> count_accepted_proposals(const ShardedPrefixTree &tree, const std::vector<Query> &queries, unsigned threads) {
+    std::vector<FrontierCounts> shard_counts(tree.shards.size(), FrontierCounts(queries));
+    parallel_for(tree.shards.size(), threads, [&](size_t s) {
+        add_frontier_counts(tree.shards[s], shard_counts[s]);
+    });
+    for (size_t s = 1; s < shard_counts.size(); ++s) {
+        shard_counts[0].merge(shard_counts[s]);
+    }
+    return answer_queries(shard_counts[0], queries, tree.shards[0].alphabet_size);
+}
+
+#endif //ZK1_PREFIX_TREE_H
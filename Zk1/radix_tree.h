@@ -0,0 +1,225 @@
+#ifndef ZK1_RADIX_TREE_H
+#define ZK1_RADIX_TREE_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include "prefix_tree.h"
+
+struct RadixNode {
+    uint32_t depth = 0; // length of the prefix represented by the node
+    uint32_t word = 0; // index into RadixTree::words of a word with this prefix, the edge label is word[parent depth, depth)
+    uint32_t first_child = NO_CHILD;
+    uint32_t next_sibling = NO_CHILD;
+    uint32_t committee_count = 0;
+    uint32_t final_set = NO_SET; // index into RadixTree::final_sets, only final nodes have one
+    uint32_t final_to_here_count = 0; // members approving some prefix of the node, valid after propagate_final_to_here
+};
+
+/**
+ * Path compressed prefix tree, unary chains of the prefix tree are a single edge.
+ * Words never end inside an edge and all words below a chain pass through all of its nodes,
+ * so committee_count and finals of the kept nodes are the same as in PrefixTree.
+ * Edge labels point into the words, which point into the input buffer.
+ * Member vectors of the final nodes are allocated from an arena, as in PrefixTree.
+ */
+class RadixTree {
+public:
+    uint32_t alphabet_size;
+    std::vector<WordRef> words; // distinct words in sorted order
+    std::vector<RadixNode> nodes;
+    std::unique_ptr<MonotonicArena> final_arena;
+    std::vector<MemberSet> final_sets;
+
+    explicit RadixTree(const std::string &alphabet)
+            : alphabet_size(alphabet.size()), final_arena(new MonotonicArena()) {
+        nodes.emplace_back();
+    }
+
+    uint32_t add_node(uint32_t depth, uint32_t word) {
+        nodes.emplace_back();
+        nodes.back().depth = depth;
+        nodes.back().word = word;
+        return nodes.size() - 1;
+    }
+
+    bool is_final(uint32_t node) const {
+        return nodes[node].final_set != NO_SET;
+    }
+
+    const MemberSet &final_here(uint32_t node) const {
+        return final_sets[nodes[node].final_set];
+    }
+
+    template <typename Visit>
+    void for_each_child(uint32_t node, Visit visit) const {
+        for (uint32_t child = nodes[node].first_child; child != NO_CHILD; child = nodes[child].next_sibling) {
+            visit(child);
+        }
+    }
+
+    uint32_t child_depth(uint32_t child, uint32_t) const {
+        return nodes[child].depth;
+    }
+
+    size_t memory_bytes() const {
+        size_t bytes = nodes.capacity() * sizeof(RadixNode) + words.capacity() * sizeof(WordRef)
+                + final_sets.capacity() * sizeof(MemberSet);
+        return bytes + final_arena->reserved_bytes();
+    }
+};
+
+inline int compare_words(const WordRef &a, const WordRef &b) {
+    int cmp = memcmp(a.begin, b.begin, std::min(a.length, b.length));
+    if (cmp != 0) {
+        return cmp;
+    }
+    return a.length < b.length ? -1 : (a.length > b.length ? 1 : 0);
+}
+
+inline uint32_t common_prefix_length(const WordRef &a, const WordRef &b) {
+    uint32_t length = 0;
+    while (length < a.length && length < b.length && a.begin[length] == b.begin[length]) {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * Number of distinct values in each of the ranges [first[n], end[n]) of values, offline with a Fenwick tree
+ * which marks only the last occurrence of every value seen so far.
+ */
+inline std::vector<uint32_t> distinct_in_ranges(const std::vector<uint32_t> &values, uint32_t value_count,
+                                                const std::vector<uint32_t> &first, const std::vector<uint32_t> &end) {
+    std::vector<int32_t> fenwick(values.size() + 1, 0);
+    auto add = [&fenwick](size_t position, int32_t delta) {
+        for (size_t i = position + 1; i < fenwick.size(); i += i & (~i + 1)) {
+            fenwick[i] += delta;
+        }
+    };
+    auto prefix_sum = [&fenwick](size_t length) {
+        int64_t sum = 0;
+        for (size_t i = length; i > 0; i -= i & (~i + 1)) {
+            sum += fenwick[i];
+        }
+        return sum;
+    };
+
+    std::vector<uint32_t> by_end(first.size());
+    std::iota(by_end.begin(), by_end.end(), 0);
+    std::sort(by_end.begin(), by_end.end(), [&end](uint32_t a, uint32_t b) { return end[a] < end[b]; });
+
+    std::vector<uint32_t> distinct(first.size(), 0);
+    std::vector<int64_t> last_seen(value_count, -1);
+    size_t position = 0;
+    for (uint32_t range : by_end) {
+        for (; position < end[range]; ++position) {
+            if (last_seen[values[position]] >= 0) {
+                add(last_seen[values[position]], -1);
+            }
+            last_seen[values[position]] = position;
+            add(position, 1);
+        }
+        distinct[range] = (uint32_t) (prefix_sum(end[range]) - prefix_sum(first[range]));
+    }
+    return distinct;
+}
+
+/**
+ * Builds the radix tree directly from the sorted word list. Words are visited in sorted order keeping
+ * the path to the previous word, the path is cut back to the common prefix with the next word, splitting
+ * the edge it ends in, and the rest of the word becomes a single new edge.
+ * Subtree of every node is a contiguous range of the sorted (word, member) pairs, committee_count
+ * is the number of distinct members in the range.
+ * @param alphabet
+ * @param lists
+ * @return tree before propagate_final_to_here
+ */
+inline RadixTree build_radix(const std::string &alphabet, const EvaluationLists &lists) {
+    std::vector<uint32_t> order(lists.words.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&lists](uint32_t a, uint32_t b) {
+        int cmp = compare_words(lists.words[a], lists.words[b]);
+        return cmp != 0 ? cmp < 0 : lists.members[a] < lists.members[b];
+    });
+
+    RadixTree tree(alphabet);
+    std::vector<uint32_t> pair_members;
+    // range of pairs below the node and its last child, needed only while building
+    std::vector<uint32_t> first_pair{0}, end_pair{0}, last_child{NO_CHILD};
+    auto add_child = [&](uint32_t parent, uint32_t depth, uint32_t word) {
+        uint32_t child = tree.add_node(depth, word);
+        first_pair.push_back(pair_members.size());
+        end_pair.push_back(pair_members.size());
+        last_child.push_back(NO_CHILD);
+        if (last_child[parent] == NO_CHILD) {
+            tree.nodes[parent].first_child = child;
+        } else {
+            tree.nodes[last_child[parent]].next_sibling = child;
+        }
+        last_child[parent] = child;
+        return child;
+    };
+
+    std::vector<uint32_t> path{0};
+    for (size_t i = 0; i < order.size();) {
+        const WordRef &word = lists.words[order[i]];
+        uint32_t common = tree.words.empty() ? 0 : common_prefix_length(tree.words.back(), word);
+
+        uint32_t cut = NO_CHILD;
+        while (tree.nodes[path.back()].depth > common) {
+            cut = path.back();
+            end_pair[cut] = pair_members.size();
+            path.pop_back();
+        }
+        uint32_t parent = path.back();
+        if (tree.nodes[parent].depth < common) {
+            // cut is the last child of parent, the middle node takes its place and adopts it
+            uint32_t middle = tree.add_node(common, tree.nodes[cut].word);
+            first_pair.push_back(first_pair[cut]);
+            end_pair.push_back(first_pair[cut]);
+            last_child.push_back(cut);
+            tree.nodes[middle].first_child = cut;
+            if (tree.nodes[parent].first_child == cut) {
+                tree.nodes[parent].first_child = middle;
+            } else {
+                uint32_t sibling = tree.nodes[parent].first_child;
+                while (tree.nodes[sibling].next_sibling != cut) {
+                    sibling = tree.nodes[sibling].next_sibling;
+                }
+                tree.nodes[sibling].next_sibling = middle;
+            }
+            last_child[parent] = middle;
+            path.push_back(middle);
+            parent = middle;
+        }
+
+        tree.words.push_back(word);
+        uint32_t leaf = add_child(parent, word.length, tree.words.size() - 1);
+        path.push_back(leaf);
+        tree.nodes[leaf].final_set = tree.final_sets.size();
+        tree.final_sets.emplace_back(tree.final_arena.get());
+        MemberSet &final_here = tree.final_sets.back();
+        for (; i < order.size() && lists.words[order[i]] == word; ++i) {
+            uint32_t member = lists.members[order[i]];
+            if (final_here.empty() || final_here.back() != member) {
+                final_here.push_back(member);
+                pair_members.push_back(member);
+            }
+        }
+    }
+    for (uint32_t node : path) {
+        end_pair[node] = pair_members.size();
+    }
+
+    std::vector<uint32_t> committee_counts = distinct_in_ranges(pair_members, lists.committee_members, first_pair, end_pair);
+    for (size_t node = 0; node < tree.nodes.size(); ++node) {
+        tree.nodes[node].committee_count = committee_counts[node];
+    }
+    return tree;
+}
+
+#endif //ZK1_RADIX_TREE_H
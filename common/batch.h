@@ -0,0 +1,226 @@
+#ifndef COMMON_BATCH_H
+#define COMMON_BATCH_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Batch mode shared by the task executables, many instances are solved by one process.
+ *
+ *   task --batch [--jobs N] input...   solves the input files and writes their outputs one after another
+ *   task --batch [--jobs N] < stream   reads instances framed as "<byte count>\n<bytes>" from stdin
+ *                                      and writes every output framed the same way
+ *
+ * Instances are solved on N worker threads (1 by default), outputs are written in input order.
+ * Workers live for the whole batch, so scratch buffers a task keeps thread_local are reused across instances.
+ * The instance count, time and instances per second are written to stderr at the end.
+ */
+
+struct BatchOptions {
+    bool enabled = false;
+    unsigned jobs = 1;
+    std::vector<std::string> files;
+};
+
+/**
+ * Finds --batch, --jobs N and the input files, which follow --batch up to the next option other than --jobs.
+ * Other arguments are left to the task.
+ */
+inline BatchOptions parse_batch_options(int argc, char *argv[]) {
+    BatchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0) {
+            options.enabled = true;
+            while (i + 1 < argc && (std::strncmp(argv[i + 1], "--", 2) != 0 || std::strcmp(argv[i + 1], "--jobs") == 0)) {
+                if (std::strcmp(argv[++i], "--jobs") == 0 && i + 1 < argc) {
+                    options.jobs = (unsigned) std::max(1, std::atoi(argv[++i]));
+                } else {
+                    options.files.push_back(argv[i]);
+                }
+            }
+        } else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            options.jobs = (unsigned) std::max(1, std::atoi(argv[++i]));
+        }
+    }
+    return options;
+}
+
+inline bool read_file(FILE *file, std::vector<char> &buffer) {
+    buffer.clear();
+    char chunk[1 << 16];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + read);
+    }
+    return !std::ferror(file);
+}
+
+/**
+ * Reads an instance buffer as an istream without copying it.
+ */
+class BufferInput : public std::istream {
+public:
+    BufferInput(const char *data, size_t size) : std::istream(nullptr), view(data, size) {
+        rdbuf(&view);
+    }
+
+    explicit BufferInput(const std::vector<char> &buffer) : BufferInput(buffer.data(), buffer.size()) {}
+
+private:
+    // the get area is only read, so the const_cast is safe
+    struct View : std::streambuf {
+        View(const char *data, size_t size) {
+            char *begin = const_cast<char *>(data);
+            setg(begin, begin, begin + size);
+        }
+    };
+
+    View view;
+};
+
+/**
+ * Hands out instances to the workers and writes the outputs in input order.
+ * Solve is called as solve(input, output) with the whole instance in input and must only write to output.
+ */
+template <typename Solve>
+class BatchRunner {
+public:
+    BatchRunner(const BatchOptions &options, Solve solve) : options(options), solve(solve) {}
+
+    /**
+     * @return 0, or 1 when some input could not be read
+     */
+    int run() {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < options.jobs; ++i) {
+            workers.emplace_back([this]() { work(); });
+        }
+        size_t written = write_outputs();
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::fprintf(stderr, "batch: %zu instances, %u jobs, %.3f s, %.1f instances/s\n",
+                     written, options.jobs, seconds, seconds > 0 ? written / seconds : 0.0);
+        return failed ? 1 : 0;
+    }
+
+private:
+    const BatchOptions &options;
+    Solve solve;
+    std::mutex mutex;
+    std::condition_variable finished_changed;
+    std::map<size_t, std::string> finished;
+    size_t next_instance = 0;
+    bool input_done = false;
+    bool failed = false;
+
+    /**
+     * reads the next instance under the lock, so stdin is consumed in order
+     * @return false when there are no more instances, readable is false for a file that could not be read
+     */
+    bool next(std::vector<char> &input, size_t &index, bool &readable) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (input_done) {
+            return false;
+        }
+        readable = true;
+        bool have = options.files.empty() ? read_frame(input) : read_next_file(input, readable);
+        if (!have) {
+            input_done = true;
+            finished_changed.notify_all();
+            return false;
+        }
+        index = next_instance++;
+        return true;
+    }
+
+    bool read_next_file(std::vector<char> &input, bool &readable) {
+        if (next_instance == options.files.size()) {
+            return false;
+        }
+        const std::string &name = options.files[next_instance];
+        FILE *file = std::fopen(name.c_str(), "rb");
+        if (file == nullptr || !read_file(file, input)) {
+            std::fprintf(stderr, "batch: cannot read %s\n", name.c_str());
+            failed = true;
+            readable = false;
+        }
+        if (file != nullptr) {
+            std::fclose(file);
+        }
+        return true;
+    }
+
+    bool read_frame(std::vector<char> &input) {
+        unsigned long long length;
+        if (std::scanf("%llu", &length) != 1 || std::getchar() != '\n') {
+            return false;
+        }
+        input.resize(length);
+        if (std::fread(input.data(), 1, length, stdin) != length) {
+            std::fprintf(stderr, "batch: truncated instance %zu\n", next_instance);
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    void work() {
+        std::vector<char> input;
+        size_t index;
+        bool readable;
+        while (next(input, index, readable)) {
+            std::ostringstream output;
+            if (readable) {
+                solve(input, output);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            finished[index] = output.str();
+            finished_changed.notify_all();
+        }
+    }
+
+    size_t write_outputs() {
+        size_t index = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            finished_changed.wait(lock, [&]() { return finished.count(index) > 0 || (input_done && index == next_instance); });
+            auto output = finished.find(index);
+            if (output == finished.end()) {
+                break;
+            }
+            std::string text = std::move(output->second);
+            finished.erase(output);
+            lock.unlock();
+            if (options.files.empty()) {
+                std::printf("%zu\n", text.size());
+            }
+            std::fwrite(text.data(), 1, text.size(), stdout);
+            lock.lock();
+            index++;
+        }
+        std::fflush(stdout);
+        return index;
+    }
+};
+
+template <typename Solve>
+int run_batch(const BatchOptions &options, Solve solve) {
+    return BatchRunner<Solve>(options, solve).run();
+}
+
+#endif //COMMON_BATCH_H
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <fcntl.h>
+#include "binary_input.h"
+
+/**
+ * Text input of a task parsed into the counts and arrays of the binary format.
+ */
+struct ParsedInput {
+    BinaryTask task;
+    uint32_t counts[4] = {0, 0, 0, 0};
+    std::vector<uint32_t> words;
+};
+
+bool parse_task(const std::string &name, BinaryTask &task) {
+    if (name == "hw1" || name == "hw2" || name == "hw3") {
+        task = (BinaryTask) (uint32_t) (name[2] - '0');
+        return true;
+    }
+    return false;
+}
+
+ParsedInput read_text(BinaryTask task, std::istream &input) {
+    ParsedInput parsed;
+    parsed.task = task;
+    uint32_t *counts = parsed.counts;
+    std::vector<uint32_t> &words = parsed.words;
+    if (task == BinaryTask::HW1) {
+        input >> counts[0] >> counts[1] >> counts[2] >> counts[3];
+        words.reserve(2 * (uint64_t) counts[2] + 2 * (uint64_t) counts[3]);
+        for (uint32_t i = 0; i < counts[2]; ++i) {
+            uint32_t row, column, potential;
+            input >> row >> column >> potential;
+            words.push_back((row - 1) * counts[1] + column - 1);
+            words.push_back(potential);
+        }
+        for (uint32_t i = 0; i < 2 * counts[3]; ++i) {
+            uint32_t row, column;
+            input >> row >> column;
+            words.push_back((row - 1) * counts[1] + column - 1);
+        }
+    } else if (task == BinaryTask::HW2) {
+        input >> counts[0] >> counts[1];
+        words.resize(2 * (uint64_t) counts[1]);
+        for (uint32_t &word : words) {
+            input >> word;
+        }
+    } else {
+        input >> counts[0] >> counts[1] >> counts[2];
+        words.resize(2 * (uint64_t) counts[0] * counts[2]);
+        for (uint32_t &word : words) {
+            input >> word;
+            word--;
+        }
+    }
+    return parsed;
+}
+
+void write_binary(const ParsedInput &parsed, FILE *output) {
+    uint32_t header[BINARY_HEADER_WORDS];
+    std::memcpy(header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header[1] = BINARY_VERSION;
+    header[2] = (uint32_t) parsed.task;
+    std::copy(parsed.counts, parsed.counts + 4, header + 3);
+    std::fwrite(header, sizeof(uint32_t), BINARY_HEADER_WORDS, output);
+    std::fwrite(parsed.words.data(), sizeof(uint32_t), parsed.words.size(), output);
+}
+
+void write_text(BinaryTask task, const BinaryInput &input, std::ostream &output) {
+    if (task == BinaryTask::HW1) {
+        uint32_t columns = input.count(1);
+        output << input.count(0) << ' ' << columns << ' ' << input.count(2) << ' ' << input.count(3) << '\n';
+        const uint32_t *potentials = input.array(0);
+        for (uint32_t i = 0; i < input.count(2); ++i) {
+            output << potentials[2 * i] / columns + 1 << ' ' << potentials[2 * i] % columns + 1 << ' '
+                   << potentials[2 * i + 1] << '\n';
+        }
+        const uint32_t *edges = input.array(2 * (uint64_t) input.count(2));
+        for (uint32_t i = 0; i < input.count(3); ++i) {
+            output << edges[2 * i] / columns + 1 << ' ' << edges[2 * i] % columns + 1 << ' '
+                   << edges[2 * i + 1] / columns + 1 << ' ' << edges[2 * i + 1] % columns + 1 << '\n';
+        }
+    } else if (task == BinaryTask::HW2) {
+        output << input.count(0) << ' ' << input.count(1) << '\n';
+        const InputEdge<uint32_t> *edges = input.edges(0);
+        for (uint32_t i = 0; i < input.count(1); ++i) {
+            output << edges[i].from << ' ' << edges[i].edge.to << '\n';
+        }
+    } else {
+        output << input.count(0) << ' ' << input.count(1) << ' ' << input.count(2) << '\n';
+        const InputEdge<uint32_t> *edges = input.edges(0);
+        for (uint64_t i = 0; i < (uint64_t) input.count(0) * input.count(2); ++i) {
+            output << edges[i].from + 1 << ' ' << edges[i].edge.to + 1 << '\n';
+        }
+    }
+}
+
+template <typename Function>
+double median_ms(int repetitions, Function function) {
+    std::vector<double> times;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/**
+ * Time to get the edge arrays from the text file, parsed as the tasks parse it, and from the binary file,
+ * mapped and checked, the checksum makes both read every edge.
+ */
+int benchmark(BinaryTask task, const char *text_path, const char *binary_path, int repetitions) {
+    uint64_t text_checksum = 0, binary_checksum = 0;
+    double text_ms = median_ms(repetitions, [&]() {
+        std::ifstream input(text_path);
+        ParsedInput parsed = read_text(task, input);
+        text_checksum = 0;
+        for (uint32_t word : parsed.words) {
+            text_checksum += word;
+        }
+    });
+    bool valid = true;
+    double binary_ms = median_ms(repetitions, [&]() {
+        int descriptor = open(binary_path, O_RDONLY);
+        InputFile file;
+        BinaryInput input;
+        valid = descriptor >= 0 && file.map_binary(descriptor) && input.open(file.data(), file.size(), task);
+        binary_checksum = 0;
+        if (valid) {
+            const uint32_t *words = input.array(0);
+            uint64_t count = (file.size() / sizeof(uint32_t)) - BINARY_HEADER_WORDS;
+            for (uint64_t i = 0; i < count; ++i) {
+                binary_checksum += words[i];
+            }
+        }
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+    });
+    if (!valid) {
+        std::cerr << "cannot map " << binary_path << " as binary input of the task" << std::endl;
+        return 1;
+    }
+    std::ifstream text_size(text_path, std::ios::binary | std::ios::ate), binary_size(binary_path, std::ios::binary | std::ios::ate);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(8) << "format" << std::setw(14) << "bytes" << std::setw(12) << "load ms" << std::setw(22) << "checksum" << std::endl;
+    std::cout << std::setw(8) << "text" << std::setw(14) << text_size.tellg() << std::setw(12) << text_ms << std::setw(22) << text_checksum << std::endl;
+    std::cout << std::setw(8) << "binary" << std::setw(14) << binary_size.tellg() << std::setw(12) << binary_ms << std::setw(22) << binary_checksum << std::endl;
+    return text_checksum == binary_checksum ? 0 : 1;
+}
+
+/**
+ * Converts inputs of HW1 to HW3 between the text format and the binary format of binary_input.h.
+ * usage: binary_convert to-binary hw1|hw2|hw3 < text > binary
+ *        binary_convert to-text < binary > text
+ *        binary_convert benchmark hw1|hw2|hw3 text binary [repetitions]
+ */
+int main(int argc, char *argv[]) {
+    std::ios_base::sync_with_stdio(false);
+    std::string command = argc > 1 ? argv[1] : "";
+    BinaryTask task;
+    if (command == "to-binary" && argc > 2 && parse_task(argv[2], task)) {
+        write_binary(read_text(task, std::cin), stdout);
+        return 0;
+    }
+    if (command == "to-text") {
+        InputFile file;
+        BinaryInput input;
+        bool loaded = load_binary_stdin(file);
+        task = (BinaryTask) binary_task_of(file.data(), file.size());
+        if (!loaded || !input.open(file.data(), file.size(), task)) {
+            std::cerr << "stdin is not a valid binary input" << std::endl;
+            return 1;
+        }
+        write_text(task, input, std::cout);
+        return 0;
+    }
+    if (command == "benchmark" && argc > 4 && parse_task(argv[2], task)) {
+        return benchmark(task, argv[3], argv[4], argc > 5 ? std::max(1, std::atoi(argv[5])) : 5);
+    }
+    std::cerr << "usage: binary_convert to-binary hw1|hw2|hw3 < text > binary" << std::endl
+              << "       binary_convert to-text < binary > text" << std::endl
+              << "       binary_convert benchmark hw1|hw2|hw3 text binary [repetitions]" << std::endl;
+    return 1;
+}
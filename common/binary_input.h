@@ -0,0 +1,214 @@
+#ifndef COMMON_BINARY_INPUT_H
+#define COMMON_BINARY_INPUT_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "graph.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PAL_HAVE_MMAP 1
+#endif
+
+/**
+ * Compact binary input of the graph tasks, little-endian, version 1:
+ *
+ *   char     magic[4] = "PALB"
+ *   uint32   version
+ *   uint32   task, 1 to 3 for HW1 to HW3
+ *   uint32   counts[4]
+ *   uint32   arrays, one after another
+ *
+ *   HW1 counts {rows, columns, potentials, extra edges},
+ *       arrays potentials x {vertex, potential}, extra edges x {from, to}
+ *   HW2 counts {vertices, edges, 0, 0}, arrays edges x {from, to}
+ *   HW3 counts {graphs, vertices, edges per graph, 0}, arrays graphs x edges x {from, to}
+ *
+ * Vertices are 0-based indices, HW1 vertices are row * columns + column.
+ * Edge arrays have the layout of InputEdge<uint32_t>, so a mapped file is used as the edge array without copying.
+ * Inputs starting with the magic are binary, everything else is the text format of the task.
+ */
+
+constexpr char BINARY_MAGIC[4] = {'P', 'A', 'L', 'B'};
+constexpr uint32_t BINARY_VERSION = 1;
+constexpr size_t BINARY_HEADER_WORDS = 7;
+
+static_assert(sizeof(InputEdge<uint32_t>) == 2 * sizeof(uint32_t), "edge arrays are read in place");
+
+enum class BinaryTask : uint32_t {HW1 = 1, HW2 = 2, HW3 = 3};
+
+inline bool little_endian_host() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t *>(&probe) == 1;
+}
+
+inline bool is_binary_input(const char *data, size_t size) {
+    return size >= sizeof(BINARY_MAGIC) && std::memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+}
+
+/**
+ * @return task field of the header, 0 when data is too short
+ */
+inline uint32_t binary_task_of(const char *data, size_t size) {
+    return size >= 3 * sizeof(uint32_t) ? reinterpret_cast<const uint32_t *>(data)[2] : 0;
+}
+
+/**
+ * Checked view of a binary input held elsewhere, valid while the data is.
+ */
+class BinaryInput {
+public:
+    /**
+     * @param data - aligned to 4 bytes
+     * @return whether data is a complete binary input of the task whose vertices are all below the vertex count,
+     *         rows * columns for HW1, which must fit in uint32 like the other counts, so the tasks can index
+     *         their arrays by them unchecked
+     */
+    bool open(const char *data, size_t size, BinaryTask task) {
+        words = reinterpret_cast<const uint32_t *>(data);
+        word_count = size / sizeof(uint32_t);
+        if (!is_binary_input(data, size) || !little_endian_host() || word_count < BINARY_HEADER_WORDS
+                || words[1] != BINARY_VERSION || words[2] != (uint32_t) task) {
+            return false;
+        }
+        uint64_t needed = BINARY_HEADER_WORDS;
+        if (task == BinaryTask::HW1) {
+            needed += 2 * (uint64_t) count(2) + 2 * (uint64_t) count(3);
+        } else if (task == BinaryTask::HW2) {
+            needed += 2 * (uint64_t) count(1);
+        } else {
+            needed += 2 * (uint64_t) count(0) * count(2);
+        }
+        if (needed > word_count) {
+            return false;
+        }
+        if (task == BinaryTask::HW1) {
+            uint64_t vertices = (uint64_t) count(0) * count(1);
+            if (vertices > UINT32_MAX) {
+                return false;
+            }
+            return all_below(0, 2 * (uint64_t) count(2), 2, vertices)
+                    && all_below(2 * (uint64_t) count(2), 2 * (uint64_t) count(3), 1, vertices);
+        }
+        if (task == BinaryTask::HW2) {
+            return all_below(0, 2 * (uint64_t) count(1), 1, count(0));
+        }
+        return all_below(0, 2 * (uint64_t) count(0) * count(2), 1, count(1));
+    }
+
+    uint32_t count(size_t index) const {
+        return words[3 + index];
+    }
+
+    /**
+     * @param offset - in words from the end of the header
+     */
+    const uint32_t *array(uint64_t offset) const {
+        return words + BINARY_HEADER_WORDS + offset;
+    }
+
+    const InputEdge<uint32_t> *edges(uint64_t offset) const {
+        return reinterpret_cast<const InputEdge<uint32_t> *>(array(offset));
+    }
+
+private:
+    const uint32_t *words = nullptr;
+    size_t word_count = 0;
+
+    /**
+     * @return whether every stride-th word of the values words of the array from offset is below limit
+     */
+    bool all_below(uint64_t offset, uint64_t values, uint64_t stride, uint64_t limit) const {
+        const uint32_t *values_begin = array(offset);
+        for (uint64_t i = 0; i < values; i += stride) {
+            if (values_begin[i] >= limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * Whole content of a file, mapped when it is a regular file and read otherwise, such as from a pipe.
+ */
+class InputFile {
+public:
+    InputFile() = default;
+
+    InputFile(const InputFile &) = delete;
+
+    InputFile &operator=(const InputFile &) = delete;
+
+    ~InputFile() {
+#ifdef PAL_HAVE_MMAP
+        if (mapped != nullptr) {
+            munmap(mapped, mapped_size);
+        }
+#endif
+    }
+
+    /**
+     * Maps the whole file when it is a regular file starting with the binary magic, the file position is not moved.
+     */
+    bool map_binary(int descriptor) {
+#ifdef PAL_HAVE_MMAP
+        struct stat status;
+        char magic[sizeof(BINARY_MAGIC)];
+        if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode) || lseek(descriptor, 0, SEEK_CUR) != 0
+                || pread(descriptor, magic, sizeof(magic), 0) != (ssize_t) sizeof(magic)
+                || !is_binary_input(magic, sizeof(magic))) {
+            return false;
+        }
+        void *memory = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (memory == MAP_FAILED) {
+            return false;
+        }
+        mapped = memory;
+        mapped_size = status.st_size;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Reads the rest of the stream when it starts with the binary magic, otherwise nothing is consumed.
+     */
+    bool read_binary(std::istream &input) {
+        if (input.peek() != BINARY_MAGIC[0]) {
+            return false;
+        }
+        buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    const char *data() const {
+        return mapped != nullptr ? static_cast<const char *>(mapped) : buffer.data();
+    }
+
+    size_t size() const {
+        return mapped != nullptr ? mapped_size : buffer.size();
+    }
+
+private:
+    void *mapped = nullptr;
+    size_t mapped_size = 0;
+    std::vector<char> buffer;
+};
+
+/**
+ * Binary stdin is mapped, or read when it is not a regular file, text stdin is left to the text parser.
+ * @return whether stdin is binary
+ */
+inline bool load_binary_stdin(InputFile &file) {
+    return file.map_binary(0) || file.read_binary(std::cin);
+}
+
+#endif //COMMON_BINARY_INPUT_H
@@ -0,0 +1,184 @@
+#ifndef COMMON_GENERATOR_H
+#define COMMON_GENERATOR_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/**
+ * Pieces shared by the input generators of all tasks. Everything is deterministic for a given seed
+ * on every platform, so no standard distributions are used.
+ */
+
+inline uint64_t split_mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        state += 0x9E3779B97F4A7C15ull;
+        return split_mix(state);
+    }
+
+    /**
+     * @return uniform value from [0, bound), bound > 0
+     */
+    uint64_t below(uint64_t bound) {
+        return next() % bound;
+    }
+
+    /**
+     * @return uniform value from [low, high]
+     */
+    int64_t between(int64_t low, int64_t high) {
+        return low + (int64_t) below((uint64_t) (high - low) + 1);
+    }
+
+    bool chance(double probability) {
+        return (next() >> 11) * (1.0 / 9007199254740992.0) < probability;
+    }
+
+private:
+    uint64_t state;
+};
+
+/**
+ * Keyed bijection of [0, size) evaluated in constant memory, used to pick distinct values or to visit
+ * things in random order without storing them. Invertible rounds on the smallest enclosing power of two
+ * are repeated until the value falls back into the range, which takes less than two tries on average.
+ */
+class RandomPermutation {
+public:
+    RandomPermutation(uint64_t size, Random &random) : size(size), mask(1), bits(1) {
+        while (mask < size - 1) {
+            mask = mask << 1 | 1;
+            bits++;
+        }
+        for (int round = 0; round < ROUNDS; ++round) {
+            multipliers[round] = random.next() | 1;
+            keys[round] = random.next();
+        }
+    }
+
+    uint64_t operator()(uint64_t index) const {
+        uint64_t x = index;
+        do {
+            for (int round = 0; round < ROUNDS; ++round) {
+                x = (x * multipliers[round]) & mask;
+                x ^= x >> (bits / 2 + 1);
+                x = (x + keys[round]) & mask;
+            }
+        } while (x >= size);
+        return x;
+    }
+
+private:
+    static constexpr int ROUNDS = 4;
+    uint64_t size, mask;
+    int bits;
+    uint64_t multipliers[ROUNDS], keys[ROUNDS];
+};
+
+/**
+ * Buffered stdout writer, the instance is streamed and never kept in memory.
+ */
+class Output {
+public:
+    Output() : used(0) {}
+
+    ~Output() {
+        flush();
+    }
+
+    Output &operator<<(char c) {
+        if (used == sizeof(buffer)) {
+            flush();
+        }
+        buffer[used++] = c;
+        return *this;
+    }
+
+    Output &operator<<(const std::string &text) {
+        for (char c : text) {
+            *this << c;
+        }
+        return *this;
+    }
+
+    Output &operator<<(const char *text) {
+        while (*text != '\0') {
+            *this << *text++;
+        }
+        return *this;
+    }
+
+    Output &operator<<(int64_t number) {
+        if (number < 0) {
+            *this << '-';
+            return *this << (uint64_t) -(number + 1) + 1;
+        }
+        return *this << (uint64_t) number;
+    }
+
+    Output &operator<<(uint64_t number) {
+        char digits[20];
+        int count = 0;
+        do {
+            digits[count++] = (char) ('0' + number % 10);
+            number /= 10;
+        } while (number > 0);
+        while (count > 0) {
+            *this << digits[--count];
+        }
+        return *this;
+    }
+
+    Output &operator<<(int number) {
+        return *this << (int64_t) number;
+    }
+
+    Output &operator<<(uint32_t number) {
+        return *this << (uint64_t) number;
+    }
+
+    void flush() {
+        fwrite(buffer, 1, used, stdout);
+        used = 0;
+    }
+
+private:
+    char buffer[1 << 16];
+    size_t used;
+};
+
+/**
+ * Common arguments of the generators: generator [scale] [seed] [task specific...],
+ * scale multiplies the size of the largest public instance, 1 by default.
+ */
+struct GeneratorArguments {
+    double scale = 1;
+    uint64_t seed = 1;
+
+    GeneratorArguments(int argc, char *argv[]) {
+        if (argc > 1) {
+            scale = std::atof(argv[1]);
+        }
+        if (argc > 2) {
+            seed = std::strtoull(argv[2], nullptr, 10);
+        }
+        if (scale <= 0) {
+            std::fprintf(stderr, "scale has to be positive\n");
+            std::exit(1);
+        }
+    }
+};
+
+#endif //COMMON_GENERATOR_H
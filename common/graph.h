@@ -0,0 +1,271 @@
+#ifndef COMMON_GRAPH_H
+#define COMMON_GRAPH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+/**
+ * Header-only graph core shared by the graph tasks: compressed sparse row graph with a configurable
+ * vertex id width and edge payload, builders from edge arrays and iterative traversals.
+ */
+
+struct NoPayload {};
+
+template <typename VertexId, typename Payload>
+struct CsrEdge {
+    VertexId to;
+    Payload payload;
+};
+
+template <typename VertexId>
+struct CsrEdge<VertexId, NoPayload> {
+    VertexId to;
+};
+
+/**
+ * Edge as given to the builders, the payload travels with the target.
+ */
+template <typename VertexId, typename Payload = NoPayload>
+struct InputEdge {
+    VertexId from;
+    CsrEdge<VertexId, Payload> edge;
+};
+
+template <typename Edge>
+class EdgeRange {
+public:
+    EdgeRange(Edge *first, Edge *last) : first(first), last(last) {}
+
+    Edge *begin() const {
+        return first;
+    }
+
+    Edge *end() const {
+        return last;
+    }
+
+    size_t size() const {
+        return last - first;
+    }
+
+private:
+    Edge *first, *last;
+};
+
+/**
+ * Edges of vertex v are edges[offsets[v], offsets[v + 1]) in the order they were given to the builder.
+ * @tparam VertexId unsigned type wide enough for the vertex count
+ * @tparam Payload data stored with every edge, NoPayload stores just the target
+ */
+template <typename VertexId = uint32_t, typename Payload = NoPayload>
+class CsrGraph {
+public:
+    using Vertex = VertexId;
+    using Edge = CsrEdge<VertexId, Payload>;
+
+    CsrGraph() : vertices(0), offsets(1, 0) {}
+
+    CsrGraph(VertexId vertices, std::vector<uint64_t> offsets, std::vector<Edge> edges)
+            : vertices(vertices), offsets(std::move(offsets)), edges(std::move(edges)) {}
+
+    VertexId vertex_count() const {
+        return vertices;
+    }
+
+    uint64_t edge_count() const {
+        return edges.size();
+    }
+
+    uint64_t degree(VertexId vertex) const {
+        return offsets[vertex + 1] - offsets[vertex];
+    }
+
+    EdgeRange<const Edge> neighbors(VertexId vertex) const {
+        return {edges.data() + offsets[vertex], edges.data() + offsets[vertex + 1]};
+    }
+
+    EdgeRange<Edge> neighbors(VertexId vertex) {
+        return {edges.data() + offsets[vertex], edges.data() + offsets[vertex + 1]};
+    }
+
+    size_t memory_bytes() const {
+        return offsets.capacity() * sizeof(uint64_t) + edges.capacity() * sizeof(Edge);
+    }
+
+private:
+    VertexId vertices;
+    std::vector<uint64_t> offsets;
+    std::vector<Edge> edges;
+};
+
+/**
+ * Counting sort of the edges by their source, stable, so neighbors keep the input order.
+ * @param vertices
+ * @param first, last - edge array, such as a mapped binary input
+ * @param symmetric also adds the reverse of every edge, right after the edge itself
+ */
+template <typename VertexId, typename Payload>
+CsrGraph<VertexId, Payload> build_csr(VertexId vertices, const InputEdge<VertexId, Payload> *first,
+                                      const InputEdge<VertexId, Payload> *last, bool symmetric) {
+    EdgeRange<const InputEdge<VertexId, Payload>> edges(first, last);
+    std::vector<uint64_t> offsets(vertices + (size_t) 1, 0);
+    for (const auto &input : edges) {
+        offsets[input.from + 1]++;
+        if (symmetric) {
+            offsets[input.edge.to + 1]++;
+        }
+    }
+    for (size_t v = 0; v < vertices; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    std::vector<CsrEdge<VertexId, Payload>> sorted(offsets[vertices]);
+    std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+    for (const auto &input : edges) {
+        sorted[next[input.from]++] = input.edge;
+        if (symmetric) {
+            CsrEdge<VertexId, Payload> &reverse = sorted[next[input.edge.to]++];
+            reverse = input.edge;
+            reverse.to = input.from;
+        }
+    }
+    return CsrGraph<VertexId, Payload>(vertices, std::move(offsets), std::move(sorted));
+}
+
+template <typename VertexId, typename Payload>
+CsrGraph<VertexId, Payload> build_csr(VertexId vertices, const std::vector<InputEdge<VertexId, Payload>> &edges, bool symmetric) {
+    return build_csr(vertices, edges.data(), edges.data() + edges.size(), symmetric);
+}
+
+template <typename VertexId, typename Payload>
+CsrGraph<VertexId, Payload> build_directed(VertexId vertices, const std::vector<InputEdge<VertexId, Payload>> &edges) {
+    return build_csr(vertices, edges, false);
+}
+
+template <typename VertexId, typename Payload>
+CsrGraph<VertexId, Payload> build_undirected(VertexId vertices, const std::vector<InputEdge<VertexId, Payload>> &edges) {
+    return build_csr(vertices, edges, true);
+}
+
+template <typename VertexId, typename Payload>
+CsrGraph<VertexId, Payload> build_directed(VertexId vertices, const InputEdge<VertexId, Payload> *first,
+                                           const InputEdge<VertexId, Payload> *last) {
+    return build_csr(vertices, first, last, false);
+}
+
+template <typename VertexId, typename Payload>
+CsrGraph<VertexId, Payload> build_undirected(VertexId vertices, const InputEdge<VertexId, Payload> *first,
+                                             const InputEdge<VertexId, Payload> *last) {
+    return build_csr(vertices, first, last, true);
+}
+
+/**
+ * Multi-source breadth first search, sources are discovered in the given order before anything else.
+ * @param graph
+ * @param sources
+ * @param tree_edge called as tree_edge(from, edge) when edge.to is discovered from vertex from
+ */
+template <typename Graph, typename TreeEdge>
+void breadth_first_search(const Graph &graph, const std::vector<typename Graph::Vertex> &sources, TreeEdge tree_edge) {
+    using Vertex = typename Graph::Vertex;
+    std::vector<bool> discovered(graph.vertex_count(), false);
+    std::vector<Vertex> queue;
+    queue.reserve(graph.vertex_count());
+    for (Vertex source : sources) {
+        if (!discovered[source]) {
+            discovered[source] = true;
+            queue.push_back(source);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        Vertex current = queue[head];
+        for (const auto &edge : graph.neighbors(current)) {
+            if (!discovered[edge.to]) {
+                discovered[edge.to] = true;
+                queue.push_back(edge.to);
+                tree_edge(current, edge);
+            }
+        }
+    }
+}
+
+/**
+ * Callbacks of DepthFirstSearch, visitors override the ones they need.
+ */
+struct DepthFirstVisitor {
+    template <typename Vertex>
+    void discover(Vertex) {}
+
+    // edge to a vertex discovered just now, called before discover of the target
+    template <typename Vertex>
+    void tree_edge(Vertex, Vertex) {}
+
+    // edge to an already discovered vertex, finished or not
+    template <typename Vertex>
+    void non_tree_edge(Vertex, Vertex) {}
+
+    // the search returned to from after finishing the tree edge target to
+    template <typename Vertex>
+    void finish_edge(Vertex, Vertex) {}
+
+    template <typename Vertex>
+    void finish(Vertex) {}
+};
+
+/**
+ * Iterative depth first search with an explicit stack, it visits in the same order as the recursive one
+ * and raises the same events, so deep graphs do not overflow the call stack.
+ * Discovered vertices are shared by all runs, run can be called for every root in turn.
+ */
+template <typename Graph>
+class DepthFirstSearch {
+public:
+    using Vertex = typename Graph::Vertex;
+
+    explicit DepthFirstSearch(const Graph &graph) : graph(graph), discovered(graph.vertex_count(), false) {}
+
+    bool is_discovered(Vertex vertex) const {
+        return discovered[vertex];
+    }
+
+    template <typename Visitor>
+    void run(Vertex root, Visitor &visitor) {
+        if (discovered[root]) {
+            return;
+        }
+        discovered[root] = true;
+        visitor.discover(root);
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            Vertex current = stack.back().first;
+            uint64_t &next_edge = stack.back().second;
+            auto edges = graph.neighbors(current);
+            if (next_edge == edges.size()) {
+                stack.pop_back();
+                visitor.finish(current);
+                if (!stack.empty()) {
+                    visitor.finish_edge(stack.back().first, current);
+                }
+                continue;
+            }
+            Vertex to = edges.begin()[next_edge++].to;
+            if (discovered[to]) {
+                visitor.non_tree_edge(current, to);
+            } else {
+                discovered[to] = true;
+                visitor.tree_edge(current, to);
+                visitor.discover(to);
+                stack.emplace_back(to, 0);
+            }
+        }
+    }
+
+private:
+    const Graph &graph;
+    std::vector<bool> discovered;
+    std::vector<std::pair<Vertex, uint64_t>> stack;
+};
+
+#endif //COMMON_GRAPH_H
@@ -0,0 +1,182 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <list>
+#include <chrono>
+#include <algorithm>
+#include "graph.h"
+
+/**
+ * Adjacency lists the graph tasks used before the CSR graph, neighbors have the same interface.
+ */
+template <typename VertexId, typename Payload>
+class ListGraph {
+public:
+    using Vertex = VertexId;
+    using Edge = CsrEdge<VertexId, Payload>;
+
+    ListGraph(VertexId vertices, const std::vector<InputEdge<VertexId, Payload>> &edges, bool symmetric)
+            : adjacency_list(vertices) {
+        for (const auto &input : edges) {
+            adjacency_list[input.from].push_back(input.edge);
+            if (symmetric) {
+                Edge reverse = input.edge;
+                reverse.to = input.from;
+                adjacency_list[input.edge.to].push_back(reverse);
+            }
+        }
+    }
+
+    VertexId vertex_count() const {
+        return adjacency_list.size();
+    }
+
+    const std::list<Edge> &neighbors(VertexId vertex) const {
+        return adjacency_list[vertex];
+    }
+
+    size_t memory_bytes() const {
+        // a list node holds two pointers next to the edge, the allocator adds its header
+        size_t edges = 0;
+        for (const auto &list : adjacency_list) {
+            edges += list.size();
+        }
+        return adjacency_list.capacity() * sizeof(std::list<Edge>) + edges * (2 * sizeof(void *) + sizeof(Edge) + 16);
+    }
+
+private:
+    std::vector<std::list<Edge>> adjacency_list;
+};
+
+using Edges = std::vector<InputEdge<uint32_t, uint32_t>>;
+
+/**
+ * Reads the edges of a task input into one edge array, graphs of HW3 are placed side by side.
+ * @return vertex count, edges are filled in
+ */
+uint32_t read_task(const std::string &task, std::istream &input, Edges &edges) {
+    if (task == "hw1") {
+        uint32_t rows, columns, potentials, extra;
+        input >> rows >> columns >> potentials >> extra;
+        for (uint32_t row = 0; row < rows; ++row) {
+            for (uint32_t column = 0; column < columns; ++column) {
+                uint32_t index = row * columns + column;
+                if (column + 1 < columns) {
+                    edges.push_back({index, {index + 1, 1}});
+                }
+                if (row + 1 < rows) {
+                    edges.push_back({index, {index + columns, 1}});
+                }
+            }
+        }
+        for (uint32_t i = 0, skip; i < 3 * potentials; ++i) {
+            input >> skip;
+        }
+        for (uint32_t i = 0; i < extra; ++i) {
+            uint32_t from_row, from_column, to_row, to_column;
+            input >> from_row >> from_column >> to_row >> to_column;
+            edges.push_back({(from_row - 1) * columns + from_column - 1, {(to_row - 1) * columns + to_column - 1, 1}});
+        }
+        return rows * columns;
+    }
+    if (task == "hw2") {
+        uint32_t vertices, edge_count;
+        input >> vertices >> edge_count;
+        edges.resize(edge_count);
+        for (auto &edge : edges) {
+            input >> edge.from >> edge.edge.to;
+            edge.edge.payload = 1;
+        }
+        return vertices;
+    }
+    uint32_t graphs, vertices, edge_count;
+    input >> graphs >> vertices >> edge_count;
+    edges.resize((size_t) graphs * edge_count);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        uint32_t offset = (uint32_t) (i / edge_count) * vertices;
+        input >> edges[i].from >> edges[i].edge.to;
+        edges[i].from += offset - 1;
+        edges[i].edge.to += offset - 1;
+        edges[i].edge.payload = 1;
+    }
+    return graphs * vertices;
+}
+
+template <typename Function>
+double median_ms(int repetitions, Function function) {
+    std::vector<double> times;
+    for (int i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+/**
+ * Build time, breadth first search from every undiscovered vertex and a plain scan of all the edges.
+ */
+template <typename Graph, typename Build>
+void measure(const std::string &name, int repetitions, Build build) {
+    uint64_t checksum = 0;
+    double build_ms = median_ms(repetitions, [&]() { checksum += build().vertex_count(); });
+    Graph graph = build();
+    double bfs_ms = median_ms(repetitions, [&]() {
+        std::vector<uint32_t> sources(graph.vertex_count());
+        for (uint32_t v = 0; v < graph.vertex_count(); ++v) {
+            sources[v] = v;
+        }
+        breadth_first_search(graph, sources, [&checksum](uint32_t, const typename Graph::Edge &edge) {
+            checksum += edge.to;
+        });
+    });
+    double scan_ms = median_ms(repetitions, [&]() {
+        for (uint32_t v = 0; v < graph.vertex_count(); ++v) {
+            for (const auto &edge : graph.neighbors(v)) {
+                checksum += edge.payload;
+            }
+        }
+    });
+    std::cout << std::setw(6) << name << std::setw(12) << build_ms << std::setw(12) << bfs_ms
+              << std::setw(12) << scan_ms << std::setw(14) << graph.memory_bytes()
+              << std::setw(22) << checksum << std::endl;
+}
+
+/**
+ * List based graph against CSR graph on a task input, times are medians over the repetitions.
+ * usage: graph_benchmark hw1|hw2|hw3 input [repetitions]
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: graph_benchmark hw1|hw2|hw3 input [repetitions]" << std::endl;
+        return 1;
+    }
+    std::string task = argv[1];
+    std::ifstream input(argv[2]);
+    if (!input) {
+        std::cerr << "cannot open " << argv[2] << std::endl;
+        return 1;
+    }
+    int repetitions = argc > 3 ? std::max(1, std::atoi(argv[3])) : 5;
+
+    Edges edges;
+    uint32_t vertices = read_task(task, input, edges);
+    bool symmetric = task != "hw2";
+    std::cout << task << " vertices " << vertices << " input edges " << edges.size() << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(6) << "graph" << std::setw(12) << "build ms" << std::setw(12) << "bfs ms"
+              << std::setw(12) << "scan ms" << std::setw(14) << "bytes" << std::setw(22) << "checksum" << std::endl;
+    measure<ListGraph<uint32_t, uint32_t>>("list", repetitions, [&]() {
+        return ListGraph<uint32_t, uint32_t>(vertices, edges, symmetric);
+    });
+    measure<CsrGraph<uint32_t, uint32_t>>("csr", repetitions, [&]() {
+        return build_csr(vertices, edges, symmetric);
+    });
+    return 0;
+}
@@ -0,0 +1,295 @@
+#ifndef COMMON_INSTRUMENTATION_H
+#define COMMON_INSTRUMENTATION_H
+
+/**
+ * Phase timers, allocation counters and hardware counters for the task executables.
+ * Compiled in only when PAL_INSTRUMENTATION is defined (cmake -DPAL_INSTRUMENTATION=ON), otherwise
+ * the macros expand to nothing and the executables are unchanged.
+ * With it compiled in, the report is written to stderr at exit when the environment variable PAL_PROFILE
+ * is "text" or "json", cycles, cache misses and branch misses are added when PAL_PROFILE_COUNTERS is set too.
+ * Phases are timed on the main thread only, allocations and counters include all the threads.
+ * The global operator new is replaced, so include this only from the translation unit with main.
+ *
+ * PROFILE_SCOPE("name") times the rest of the enclosing block,
+ * PROFILE_START(timer, "name") and PROFILE_NEXT(timer, "name") time consecutive phases of one block.
+ */
+
+#ifdef PAL_INSTRUMENTATION
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static std::atomic<uint64_t> allocation_count{0};
+static std::atomic<uint64_t> allocated_bytes{0};
+// initialized before main runs, phases started on other threads, such as batch workers, are not timed
+static const std::thread::id main_thread_id = std::this_thread::get_id();
+
+// the replacements stay out of line, inlined into a caller GCC pairs the free of a delete with the new
+// expression that allocated the memory and warns of a mismatch (-Wmismatched-new-delete)
+#if defined(__GNUC__)
+#define PAL_NOINLINE __attribute__((noinline))
+#else
+#define PAL_NOINLINE
+#endif
+
+PAL_NOINLINE void *operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    void *memory = std::malloc(size > 0 ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+PAL_NOINLINE void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+PAL_NOINLINE void operator delete(void *memory, size_t) noexcept {
+    std::free(memory);
+}
+
+/**
+ * Cycles, cache misses and branch misses of the process and of the threads it starts, user space only.
+ * Stays unavailable when perf_event_open is not permitted.
+ */
+class HardwareCounters {
+public:
+    static constexpr int COUNT = 3;
+
+    void open() {
+#if defined(__linux__)
+        const uint64_t configs[COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < COUNT; ++i) {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = configs[i];
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.inherit = 1;
+            descriptors[i] = (int) syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+        }
+#endif
+    }
+
+    bool available() const {
+        return descriptors[0] >= 0;
+    }
+
+    void read_values(uint64_t values[COUNT]) const {
+        for (int i = 0; i < COUNT; ++i) {
+            values[i] = 0;
+#if defined(__linux__)
+            if (descriptors[i] >= 0 && ::read(descriptors[i], &values[i], sizeof(values[i])) != sizeof(values[i])) {
+                values[i] = 0;
+            }
+#endif
+        }
+    }
+
+private:
+    int descriptors[COUNT] = {-1, -1, -1};
+};
+
+struct PhaseTotals {
+    const char *name;
+    int depth;
+    uint64_t calls = 0;
+    double seconds = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t counters[HardwareCounters::COUNT] = {0, 0, 0};
+};
+
+/**
+ * Totals of every phase in the order the phases were first entered, reported when the program exits.
+ */
+class Profiler {
+public:
+    enum class Format {NONE, TEXT, JSON};
+
+    static Profiler &instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    bool enabled() const {
+        return format != Format::NONE;
+    }
+
+    const HardwareCounters &hardware() const {
+        return counters;
+    }
+
+    size_t enter(const char *name) {
+        size_t phase = 0;
+        while (phase < phases.size() && (phases[phase].depth != depth || std::strcmp(phases[phase].name, name) != 0)) {
+            phase++;
+        }
+        if (phase == phases.size()) {
+            phases.emplace_back();
+            phases.back().name = name;
+            phases.back().depth = depth;
+        }
+        depth++;
+        return phase;
+    }
+
+    PhaseTotals &leave(size_t phase) {
+        depth--;
+        return phases[phase];
+    }
+
+    ~Profiler() {
+        if (format == Format::TEXT) {
+            report_text();
+        } else if (format == Format::JSON) {
+            report_json();
+        }
+    }
+
+private:
+    Format format = Format::NONE;
+    int depth = 0;
+    std::vector<PhaseTotals> phases;
+    HardwareCounters counters;
+
+    Profiler() {
+        const char *setting = std::getenv("PAL_PROFILE");
+        if (setting != nullptr) {
+            format = std::strcmp(setting, "json") == 0 ? Format::JSON : Format::TEXT;
+        }
+        if (enabled() && std::getenv("PAL_PROFILE_COUNTERS") != nullptr) {
+            counters.open();
+        }
+    }
+
+    void report_text() const {
+        std::fprintf(stderr, "%-28s %8s %12s %12s %14s", "phase", "calls", "ms", "allocations", "bytes");
+        if (counters.available()) {
+            std::fprintf(stderr, " %14s %14s %14s", "cycles", "cache misses", "branch misses");
+        }
+        std::fprintf(stderr, "\n");
+        for (const PhaseTotals &phase : phases) {
+            std::string name = std::string(2 * phase.depth, ' ') + phase.name;
+            std::fprintf(stderr, "%-28s %8llu %12.3f %12llu %14llu", name.c_str(), (unsigned long long) phase.calls,
+                         phase.seconds * 1e3, (unsigned long long) phase.allocations, (unsigned long long) phase.bytes);
+            if (counters.available()) {
+                for (uint64_t value : phase.counters) {
+                    std::fprintf(stderr, " %14llu", (unsigned long long) value);
+                }
+            }
+            std::fprintf(stderr, "\n");
+        }
+    }
+
+    void report_json() const {
+        const char *counter_names[HardwareCounters::COUNT] = {"cycles", "cache_misses", "branch_misses"};
+        std::fprintf(stderr, "{\"phases\": [");
+        for (size_t i = 0; i < phases.size(); ++i) {
+            const PhaseTotals &phase = phases[i];
+            std::fprintf(stderr, "%s\n  {\"name\": \"%s\", \"depth\": %d, \"calls\": %llu, \"ms\": %.3f, "
+                                 "\"allocations\": %llu, \"allocated_bytes\": %llu",
+                         i > 0 ? "," : "", phase.name, phase.depth, (unsigned long long) phase.calls, phase.seconds * 1e3,
+                         (unsigned long long) phase.allocations, (unsigned long long) phase.bytes);
+            if (counters.available()) {
+                for (int counter = 0; counter < HardwareCounters::COUNT; ++counter) {
+                    std::fprintf(stderr, ", \"%s\": %llu", counter_names[counter], (unsigned long long) phase.counters[counter]);
+                }
+            }
+            std::fprintf(stderr, "}");
+        }
+        std::fprintf(stderr, "\n]}\n");
+    }
+};
+
+/**
+ * Adds the time, allocations and counters between start and stop to the totals of the phase.
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(const char *name) {
+        start(name);
+    }
+
+    ~PhaseTimer() {
+        stop();
+    }
+
+    void next(const char *name) {
+        stop();
+        start(name);
+    }
+
+private:
+    bool running = false;
+    size_t phase = 0;
+    std::chrono::steady_clock::time_point start_time;
+    uint64_t start_allocations = 0, start_bytes = 0;
+    uint64_t start_counters[HardwareCounters::COUNT] = {0, 0, 0};
+
+    void start(const char *name) {
+        Profiler &profiler = Profiler::instance();
+        running = profiler.enabled() && std::this_thread::get_id() == main_thread_id;
+        if (!running) {
+            return;
+        }
+        phase = profiler.enter(name);
+        profiler.hardware().read_values(start_counters);
+        start_allocations = allocation_count.load(std::memory_order_relaxed);
+        start_bytes = allocated_bytes.load(std::memory_order_relaxed);
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    void stop() {
+        if (!running) {
+            return;
+        }
+        running = false;
+        auto end_time = std::chrono::steady_clock::now();
+        uint64_t end_counters[HardwareCounters::COUNT];
+        Profiler &profiler = Profiler::instance();
+        profiler.hardware().read_values(end_counters);
+        PhaseTotals &totals = profiler.leave(phase);
+        totals.calls++;
+        totals.seconds += std::chrono::duration<double>(end_time - start_time).count();
+        totals.allocations += allocation_count.load(std::memory_order_relaxed) - start_allocations;
+        totals.bytes += allocated_bytes.load(std::memory_order_relaxed) - start_bytes;
+        for (int i = 0; i < HardwareCounters::COUNT; ++i) {
+            totals.counters[i] += end_counters[i] - start_counters[i];
+        }
+    }
+};
+
+#define PAL_CONCATENATE_(a, b) a##b
+#define PAL_CONCATENATE(a, b) PAL_CONCATENATE_(a, b)
+#define PROFILE_SCOPE(name) PhaseTimer PAL_CONCATENATE(phase_timer_, __LINE__)(name)
+#define PROFILE_START(timer, name) PhaseTimer timer(name)
+#define PROFILE_NEXT(timer, name) timer.next(name)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_START(timer, name)
+#define PROFILE_NEXT(timer, name)
+
+#endif //PAL_INSTRUMENTATION
+
+#endif //COMMON_INSTRUMENTATION_H
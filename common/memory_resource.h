@@ -0,0 +1,263 @@
+#ifndef COMMON_MEMORY_RESOURCE_H
+#define COMMON_MEMORY_RESOURCE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Polymorphic memory resources in the spirit of std::pmr for the C++11 tasks: a monotonic arena,
+ * a pool of equally sized blocks and an allocator that lets standard containers use either of them.
+ * Every resource counts its allocations, so the reduction of heap traffic can be checked,
+ * together with the allocation counters of instrumentation.h.
+ * None of the resources is thread-safe, each thread needs its own.
+ */
+class MemoryResource {
+public:
+    virtual ~MemoryResource() = default;
+
+    void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        allocation_count++;
+        allocated_bytes += bytes;
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void *memory, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        do_deallocate(memory, bytes, alignment);
+    }
+
+    uint64_t allocations() const {
+        return allocation_count;
+    }
+
+    uint64_t bytes() const {
+        return allocated_bytes;
+    }
+
+protected:
+    virtual void *do_allocate(size_t bytes, size_t alignment) = 0;
+
+    virtual void do_deallocate(void *memory, size_t bytes, size_t alignment) = 0;
+
+private:
+    uint64_t allocation_count = 0;
+    uint64_t allocated_bytes = 0;
+};
+
+/**
+ * Global operator new and delete.
+ */
+class NewDeleteResource : public MemoryResource {
+protected:
+    void *do_allocate(size_t bytes, size_t) override {
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void *memory, size_t, size_t) override {
+        ::operator delete(memory);
+    }
+};
+
+inline MemoryResource *new_delete_resource() {
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+/**
+ * Bump allocation from blocks of doubling size taken from the upstream resource,
+ * deallocation does nothing and everything is returned at once by release or the destructor.
+ */
+class MonotonicArena : public MemoryResource {
+public:
+    explicit MonotonicArena(size_t initial_block = 1 << 16, MemoryResource *upstream = new_delete_resource())
+            : upstream(upstream), next_block(std::max<size_t>(initial_block, 64)) {}
+
+    MonotonicArena(const MonotonicArena &) = delete;
+
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+    ~MonotonicArena() override {
+        release();
+    }
+
+    void release() {
+        for (const auto &block : blocks) {
+            upstream->deallocate(block.first, block.second);
+        }
+        blocks.clear();
+        current = end = nullptr;
+    }
+
+    /**
+     * @return bytes taken from the upstream resource
+     */
+    size_t reserved_bytes() const {
+        size_t reserved = 0;
+        for (const auto &block : blocks) {
+            reserved += block.second;
+        }
+        return reserved;
+    }
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~(uintptr_t) (alignment - 1);
+        if (current == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(end)) {
+            size_t size = std::max(next_block, bytes + alignment);
+            next_block = 2 * size;
+            current = static_cast<char *>(upstream->allocate(size));
+            end = current + size;
+            blocks.emplace_back(current, size);
+            aligned = (reinterpret_cast<uintptr_t>(current) + alignment - 1) & ~(uintptr_t) (alignment - 1);
+        }
+        current = reinterpret_cast<char *>(aligned + bytes);
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+private:
+    MemoryResource *upstream;
+    size_t next_block;
+    char *current = nullptr;
+    char *end = nullptr;
+    std::vector<std::pair<char *, size_t>> blocks;
+};
+
+/**
+ * Free lists of blocks in size classes of 8 bytes carved from chunks of the upstream resource, for node based
+ * containers, which allocate and free many blocks of a few sizes. Larger requests go upstream.
+ */
+class PoolResource : public MemoryResource {
+public:
+    explicit PoolResource(size_t largest_block = 256, MemoryResource *upstream = new_delete_resource())
+            : upstream(upstream), pools(size_class(std::max(largest_block, GRANULE)) + 1) {}
+
+    PoolResource(const PoolResource &) = delete;
+
+    PoolResource &operator=(const PoolResource &) = delete;
+
+    ~PoolResource() override {
+        release();
+    }
+
+    /**
+     * Returns all the chunks upstream, blocks still in use become invalid.
+     */
+    void release() {
+        for (const auto &chunk : chunks) {
+            upstream->deallocate(chunk.first, chunk.second);
+        }
+        chunks.clear();
+        for (Pool &pool : pools) {
+            pool = Pool();
+        }
+    }
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        if (!fits(bytes, alignment)) {
+            return upstream->allocate(bytes, alignment);
+        }
+        Pool &pool = pools[size_class(bytes)];
+        if (pool.free_list == nullptr) {
+            refill(pool, size_class(bytes) * GRANULE);
+        }
+        FreeBlock *block = pool.free_list;
+        pool.free_list = block->next;
+        return block;
+    }
+
+    void do_deallocate(void *memory, size_t bytes, size_t alignment) override {
+        if (!fits(bytes, alignment)) {
+            upstream->deallocate(memory, bytes, alignment);
+            return;
+        }
+        Pool &pool = pools[size_class(bytes)];
+        FreeBlock *block = static_cast<FreeBlock *>(memory);
+        block->next = pool.free_list;
+        pool.free_list = block;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    struct Pool {
+        FreeBlock *free_list = nullptr;
+        size_t next_chunk_blocks = 64;
+    };
+
+    static constexpr size_t GRANULE = 8;
+
+    MemoryResource *upstream;
+    std::vector<Pool> pools;
+    std::vector<std::pair<char *, size_t>> chunks;
+
+    static size_t size_class(size_t bytes) {
+        return (std::max<size_t>(bytes, 1) + GRANULE - 1) / GRANULE;
+    }
+
+    // blocks start at multiples of their size from a chunk aligned by the upstream resource
+    bool fits(size_t bytes, size_t alignment) const {
+        return size_class(bytes) < pools.size() && alignment <= alignof(std::max_align_t)
+                && size_class(bytes) * GRANULE % alignment == 0;
+    }
+
+    void refill(Pool &pool, size_t block_size) {
+        size_t size = pool.next_chunk_blocks * block_size;
+        char *chunk = static_cast<char *>(upstream->allocate(size));
+        chunks.emplace_back(chunk, size);
+        for (size_t offset = size; offset >= block_size; offset -= block_size) {
+            FreeBlock *block = reinterpret_cast<FreeBlock *>(chunk + offset - block_size);
+            block->next = pool.free_list;
+            pool.free_list = block;
+        }
+        pool.next_chunk_blocks = std::min<size_t>(2 * pool.next_chunk_blocks, 1 << 16);
+    }
+};
+
+/**
+ * Standard allocator over a MemoryResource, containers using it allocate from the resource,
+ * which has to outlive them. Copies and rebinds share the resource.
+ */
+template <typename T>
+class ResourceAllocator {
+public:
+    using value_type = T;
+
+    ResourceAllocator(MemoryResource *resource = new_delete_resource()) : resource(resource) {}
+
+    template <typename U>
+    ResourceAllocator(const ResourceAllocator<U> &other) : resource(other.get_resource()) {}
+
+    T *allocate(size_t count) {
+        return static_cast<T *>(resource->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *memory, size_t count) {
+        resource->deallocate(memory, count * sizeof(T), alignof(T));
+    }
+
+    MemoryResource *get_resource() const {
+        return resource;
+    }
+
+private:
+    MemoryResource *resource;
+};
+
+template <typename T, typename U>
+bool operator==(const ResourceAllocator<T> &a, const ResourceAllocator<U> &b) {
+    return a.get_resource() == b.get_resource();
+}
+
+template <typename T, typename U>
+bool operator!=(const ResourceAllocator<T> &a, const ResourceAllocator<U> &b) {
+    return !(a == b);
+}
+
+#endif //COMMON_MEMORY_RESOURCE_H
@@ -0,0 +1,109 @@
+#ifndef COMMON_THREAD_POOL_H
+#define COMMON_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of threads running loops of independent iterations, for the data parallel parts of a task.
+ * A pool of N threads starts N - 1 workers, the calling thread takes part in every loop, so a pool of 1 runs
+ * loops inline. Iterations are handed out one by one from a shared counter, which balances uneven iterations.
+ * Workers live as long as the pool, so scratch they keep thread_local is reused across loops.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads) {
+        for (unsigned worker = 1; worker < threads; ++worker) {
+            workers.emplace_back([this, worker]() { work(worker); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        started.notify_all();
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+    }
+
+    unsigned size() const {
+        return (unsigned) workers.size() + 1;
+    }
+
+    /**
+     * Calls function(index, thread) for every index below count and returns once all calls returned.
+     * thread is below size() and no two calls running at the same time share it.
+     */
+    void for_each(size_t count, const std::function<void(size_t, unsigned)> &function) {
+        if (workers.empty() || count <= 1) {
+            for (size_t index = 0; index < count; ++index) {
+                function(index, 0);
+            }
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            task = &function;
+            taskSize = count;
+            next.store(0);
+            busy = (unsigned) workers.size();
+            generation++;
+        }
+        started.notify_all();
+        run(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return busy == 0; });
+        task = nullptr;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable started, finished;
+    const std::function<void(size_t, unsigned)> *task = nullptr;
+    size_t taskSize = 0;
+    std::atomic<size_t> next{0};
+    unsigned busy = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    void run(unsigned thread) {
+        for (size_t index = next++; index < taskSize; index = next++) {
+            (*task)(index, thread);
+        }
+    }
+
+    void work(unsigned thread) {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                started.wait(lock, [this, seen]() { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+            run(thread);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+};
+
+#endif //COMMON_THREAD_POOL_H
@@ -0,0 +1,31 @@
+# Runs one regression case, see CMakeLists.txt:
+#   cmake -D EXECUTABLE=... -D INPUT=... [-D ARGUMENTS=a;b] [-D EXPECTED=file] [-D STATUS=n] [-D ERROR=regex]
+#         -P run_case.cmake
+# The output must equal the EXPECTED file up to whitespace, the exit status must be STATUS, 0 by default,
+# and stderr must match ERROR when it is given.
+
+if(NOT DEFINED STATUS)
+    set(STATUS 0)
+endif()
+execute_process(COMMAND ${EXECUTABLE} ${ARGUMENTS}
+        INPUT_FILE ${INPUT}
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE errors
+        RESULT_VARIABLE status)
+
+if(NOT "${status}" STREQUAL "${STATUS}")
+    message(FATAL_ERROR "exit status ${status}, expected ${STATUS}\n${errors}")
+endif()
+if(DEFINED ERROR AND NOT errors MATCHES "${ERROR}")
+    message(FATAL_ERROR "stderr does not match ${ERROR}:\n${errors}")
+endif()
+if(DEFINED EXPECTED)
+    file(READ ${EXPECTED} expected)
+    string(REGEX REPLACE "[ \t\r\n]+" " " output_words "${output}")
+    string(REGEX REPLACE "[ \t\r\n]+" " " expected_words "${expected}")
+    string(STRIP "${output_words}" output_words)
+    string(STRIP "${expected_words}" expected_words)
+    if(NOT output_words STREQUAL expected_words)
+        message(FATAL_ERROR "output differs from ${EXPECTED}:\n${output}")
+    endif()
+endif()
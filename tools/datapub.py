@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""
+Runs every task on its datapub inputs, checks the outputs against the .out files
+and reports wall time, peak memory and throughput of each input as JSON.
+
+usage: datapub.py [--build-dir DIR] [--repetitions R] [--tasks hw1,zk1,...] [--case pub01]
+                  [--output results.json] [--baseline baseline.json] [--save-baseline baseline.json]
+                  [--tolerance 0.25] [--slack-ms 20] [--batch-jobs N]
+
+--case NAME only runs the inputs of that name, ctest checks every input this way.
+Peak memory is measured through the peak_rss target of the build, see tools/peak_rss.cpp,
+and is null when it is not built.
+
+--batch-jobs N also runs all the inputs of every task in one process in batch mode on N jobs
+and reports instances per second, see common/batch.h.
+
+Exit status is 1 when some output differs or when the median time of some input is more than
+tolerance * baseline + slack-ms slower than the baseline, 0 otherwise.
+"""
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# name: (directory of the sources relative to the repository root, executable target)
+TASKS = {
+    "hw1": ("HWs/HW1_MSTwithVertexPotentials/Cpp", "hw1"),
+    "hw2": ("HWs/HW2_ExpressPaths/Cpp", "hw2"),
+    "hw3": ("HWs/HW3_FewCyclesGraphIsomorphism/Cpp", "hw3"),
+    "hw4": ("HWs/HW4_GeneticEngineering/cpp", "hw4"),
+    "hw5": ("HWs/HW5_IncompleteLCG/cpp", "hw5"),
+    "hw6": ("HWs/HW6_SplayTrees/cpp", "hw6"),
+    "zk1": ("Zk1", "zk1"),
+}
+
+
+def datapub_dir(source_dir):
+    task_dir = os.path.join(ROOT, source_dir)
+    if os.path.basename(source_dir).lower() == "cpp":
+        task_dir = os.path.dirname(task_dir)
+    return os.path.join(task_dir, "datapub")
+
+
+def cases(source_dir):
+    """pairs of (name, input path, expected output path), inputs without .out and vice versa are skipped"""
+    directory = datapub_dir(source_dir)
+    for entry in sorted(os.listdir(directory)):
+        name, extension = os.path.splitext(entry)
+        expected = os.path.join(directory, name + ".out")
+        if extension == ".in" and os.path.exists(expected):
+            yield name, os.path.join(directory, entry), expected
+
+
+# peak_rss executable of the build, None when it is not built
+peak_rss_wrapper = None
+
+
+def run_once(command, input_path=os.devnull):
+    """
+    returns (stdout, wall seconds, peak resident set size in KiB or None) of a single run,
+    the command runs under peak_rss_wrapper, which reports the peak on a pipe, because a child of this
+    script would inherit the peak of the interpreter
+    """
+    report_read, report_write = None, None
+    if peak_rss_wrapper:
+        report_read, report_write = os.pipe()
+        command = [peak_rss_wrapper, str(report_write)] + command
+    with open(input_path, "rb") as input_file:
+        start = time.perf_counter()
+        process = subprocess.Popen(command, stdin=input_file, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                                   pass_fds=(report_write,) if report_write is not None else ())
+        if report_write is not None:
+            os.close(report_write)
+        output = process.stdout.read()
+        process.stdout.close()
+        process.wait()
+        seconds = time.perf_counter() - start
+    peak = None
+    if report_read is not None:
+        with os.fdopen(report_read, "rb") as report:
+            text = report.read().strip()
+        peak = int(text) if text else None
+    return output, seconds, peak
+
+
+def rss_floor():
+    """peak of a process that does nothing, the least any input can report"""
+    return run_once(["true"])[2]
+
+
+def max_peak(peaks):
+    return None if None in peaks else max(peaks)
+
+
+def same_output(actual, expected):
+    return actual.split() == expected.split()
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def measure(executable, input_path, expected_path, repetitions):
+    with open(expected_path, "rb") as expected_file:
+        expected = expected_file.read()
+    times, peaks, correct = [], [], True
+    for _ in range(repetitions):
+        output, seconds, peak = run_once([executable], input_path)
+        correct = correct and same_output(output, expected)
+        times.append(seconds)
+        peaks.append(peak)
+    median = statistics.median(times)
+    input_bytes = os.path.getsize(input_path)
+    return {
+        "correct": correct,
+        "median_ms": round(median * 1e3, 3),
+        "p95_ms": round(percentile(times, 0.95) * 1e3, 3),
+        "peak_rss_kib": max_peak(peaks),
+        "input_bytes": input_bytes,
+        "mib_per_s": round(input_bytes / (1 << 20) / median, 3) if median > 0 else None,
+    }
+
+
+def measure_batch(executable, task_cases, jobs, repetitions):
+    expected = b""
+    for _, _, expected_path in task_cases:
+        with open(expected_path, "rb") as expected_file:
+            expected += expected_file.read() + b"\n"
+    command = [executable, "--batch", "--jobs", str(jobs)] + [input_path for _, input_path, _ in task_cases]
+    times, peaks, correct = [], [], True
+    for _ in range(repetitions):
+        output, seconds, peak = run_once(command)
+        correct = correct and same_output(output, expected)
+        times.append(seconds)
+        peaks.append(peak)
+    median = statistics.median(times)
+    return {
+        "correct": correct,
+        "jobs": jobs,
+        "instances": len(task_cases),
+        "median_ms": round(median * 1e3, 3),
+        "peak_rss_kib": max_peak(peaks),
+        "instances_per_s": round(len(task_cases) / median, 1) if median > 0 else None,
+    }
+
+
+def regressions(results, baseline, tolerance, slack_ms):
+    for task, inputs in results.items():
+        for name, result in inputs.items():
+            reference = baseline.get(task, {}).get(name)
+            if reference is None:
+                continue
+            limit = reference["median_ms"] * (1 + tolerance) + slack_ms
+            if result["median_ms"] > limit:
+                yield "%s/%s median %.1f ms, baseline %.1f ms, limit %.1f ms" % (
+                    task, name, result["median_ms"], reference["median_ms"], limit)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="datapub correctness and performance runner")
+    parser.add_argument("--build-dir", default=os.path.join(ROOT, "build"))
+    parser.add_argument("--repetitions", type=int, default=5)
+    parser.add_argument("--tasks", default=",".join(TASKS))
+    parser.add_argument("--case")
+    parser.add_argument("--output")
+    parser.add_argument("--baseline")
+    parser.add_argument("--save-baseline")
+    parser.add_argument("--tolerance", type=float, default=0.25)
+    parser.add_argument("--slack-ms", type=float, default=20.0)
+    parser.add_argument("--batch-jobs", type=int, default=0)
+    arguments = parser.parse_args()
+    global peak_rss_wrapper
+    wrapper = os.path.join(arguments.build_dir, "tools", "peak_rss")
+    peak_rss_wrapper = wrapper if os.path.exists(wrapper) else None
+
+    results, batches, failures = {}, {}, []
+    for task in arguments.tasks.split(","):
+        source_dir, target = TASKS[task]
+        executable = os.path.join(arguments.build_dir, source_dir, target)
+        if not os.path.exists(executable):
+            failures.append("%s: missing executable %s" % (task, executable))
+            continue
+        results[task] = {}
+        task_cases = [case for case in cases(source_dir) if arguments.case in (None, case[0])]
+        if not task_cases:
+            failures.append("%s: no input named %s" % (task, arguments.case))
+        for name, input_path, expected_path in task_cases:
+            result = measure(executable, input_path, expected_path, max(1, arguments.repetitions))
+            results[task][name] = result
+            print("%-4s %s %-5s median %10.2f ms p95 %10.2f ms rss %8s KiB" % (
+                task, name, "ok" if result["correct"] else "WRONG",
+                result["median_ms"], result["p95_ms"], result["peak_rss_kib"]), file=sys.stderr)
+            if not result["correct"]:
+                failures.append("%s/%s: output differs from %s" % (task, name, os.path.relpath(expected_path, ROOT)))
+        if arguments.batch_jobs > 0 and task_cases:
+            batch = measure_batch(executable, task_cases, arguments.batch_jobs, max(1, arguments.repetitions))
+            batches[task] = batch
+            print("%-4s batch %-5s median %10.2f ms %d instances %d jobs %10.1f instances/s" % (
+                task, "ok" if batch["correct"] else "WRONG", batch["median_ms"],
+                batch["instances"], batch["jobs"], batch["instances_per_s"]), file=sys.stderr)
+            if not batch["correct"]:
+                failures.append("%s: batch output differs from the .out files" % task)
+
+    if arguments.baseline and os.path.exists(arguments.baseline):
+        with open(arguments.baseline) as baseline_file:
+            failures.extend("regression " + line for line in regressions(
+                results, json.load(baseline_file)["tasks"], arguments.tolerance, arguments.slack_ms))
+
+    summary = {"rss_floor_kib": rss_floor(), "repetitions": arguments.repetitions, "tasks": results}
+    if batches:
+        summary["batch"] = batches
+    report = json.dumps(summary, indent=2, sort_keys=True)
+    if arguments.output:
+        with open(arguments.output, "w") as output_file:
+            output_file.write(report + "\n")
+    else:
+        print(report)
+    if arguments.save_baseline:
+        with open(arguments.save_baseline, "w") as baseline_file:
+            baseline_file.write(report + "\n")
+
+    for failure in failures:
+        print("FAIL " + failure, file=sys.stderr)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,40 @@
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * Runs a command and writes its peak resident set size in KiB to a file descriptor, for datapub.py.
+ * Linux carries the peak of the process a child was forked from over exec, so a task forked straight from
+ * the Python interpreter never reports less than the interpreter. This process is small, so the peak of the
+ * task it forks is the task's own. Standard streams are passed through, the exit status is the command's.
+ * usage: peak_rss FD command [argument...]
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: peak_rss FD command [argument...]\n");
+        return 2;
+    }
+    int report = std::atoi(argv[1]);
+    pid_t child = fork();
+    if (child < 0) {
+        std::perror("peak_rss: fork");
+        return 2;
+    }
+    if (child == 0) {
+        close(report);
+        execvp(argv[2], argv + 2);
+        std::perror("peak_rss: exec");
+        _exit(127);
+    }
+    int status;
+    struct rusage usage;
+    if (wait4(child, &status, 0, &usage) < 0) {
+        std::perror("peak_rss: wait");
+        return 2;
+    }
+    dprintf(report, "%ld\n", usage.ru_maxrss);
+    close(report);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}